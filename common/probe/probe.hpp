@@ -0,0 +1,422 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Metrics are collected only when enabled at runtime, disabled hooks cost one relaxed load:
+//   PROBE=1         enable and dump JSON into stderr on exit
+//   PROBE=<file>    enable and dump JSON into file on exit
+//   PROBE_PERF=1    sample hardware counters in PROBE_PERF_SCOPE, when perf_event_open permits
+
+namespace probe {
+
+namespace detail {
+
+inline auto env_flag(const char* const name) noexcept -> const char* {
+    const char* const val = std::getenv(name);
+    return (val and *val and std::string{val} != "0") ? val : nullptr;
+}
+
+inline auto enabled_flag() noexcept -> std::atomic<bool>& {
+    static std::atomic<bool> flag{env_flag("PROBE") != nullptr};
+    return flag;
+}
+
+inline auto now_ns() noexcept -> std::uint64_t {
+    const auto since = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(since).count());
+}
+
+inline void put_string(std::ostream& out, const std::string& str) {
+    out << '"';
+    for (const char symb: str) {
+        if (symb == '"' or symb == '\\') {
+            out << '\\';
+        }
+        out << symb;
+    }
+    out << '"';
+}
+
+}
+
+inline bool enabled() noexcept {
+    return detail::enabled_flag().load(std::memory_order_relaxed);
+}
+
+inline void enable(const bool flag) noexcept {
+    detail::enabled_flag().store(flag, std::memory_order_relaxed);
+}
+
+// Monotonic event counter.
+class counter {
+public:
+    void add(const std::uint64_t num = 1) noexcept {
+        m_value.fetch_add(num, std::memory_order_relaxed);
+    }
+
+    auto value() const noexcept -> std::uint64_t {
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::uint64_t> m_value{0};
+};
+
+// Power-of-two histogram: bucket 0 holds zeros, bucket k holds values in [2^(k-1), 2^k).
+class histogram {
+public:
+    constexpr static std::size_t buckets = 65;
+
+    void record(const std::uint64_t val) noexcept {
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(val, std::memory_order_relaxed);
+        m_bucket.at(bucket_of(val)).fetch_add(1, std::memory_order_relaxed);
+
+        for (auto min = m_min.load(std::memory_order_relaxed); val < min;) {
+            if (m_min.compare_exchange_weak(min, val, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        for (auto max = m_max.load(std::memory_order_relaxed); val > max;) {
+            if (m_max.compare_exchange_weak(max, val, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+    }
+
+    auto count() const noexcept -> std::uint64_t {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+    auto sum() const noexcept -> std::uint64_t {
+        return m_sum.load(std::memory_order_relaxed);
+    }
+
+    auto min() const noexcept -> std::uint64_t {
+        return count() ? m_min.load(std::memory_order_relaxed) : 0;
+    }
+
+    auto max() const noexcept -> std::uint64_t {
+        return m_max.load(std::memory_order_relaxed);
+    }
+
+    auto bucket(const std::size_t idx) const noexcept -> std::uint64_t {
+        return m_bucket.at(idx).load(std::memory_order_relaxed);
+    }
+
+    constexpr static auto bucket_of(const std::uint64_t val) noexcept -> std::size_t {
+        return val ? static_cast<std::size_t>(64 - __builtin_clzll(val)) : 0;
+    }
+
+private:
+    std::atomic<std::uint64_t> m_count{0};
+    std::atomic<std::uint64_t> m_sum{0};
+    std::atomic<std::uint64_t> m_min{UINT64_MAX};
+    std::atomic<std::uint64_t> m_max{0};
+    std::array<std::atomic<std::uint64_t>, buckets> m_bucket = {};
+};
+
+static_assert(histogram::bucket_of(0) == 0);
+static_assert(histogram::bucket_of(1) == 1);
+static_assert(histogram::bucket_of(1023) == 10);
+static_assert(histogram::bucket_of(UINT64_MAX) == 64);
+
+// Hardware events of calling thread, opened once as perf group; invalid when kernel,
+// container or perf_event_paranoid forbids it, readings are zero then.
+class perf_group {
+public:
+    constexpr static std::size_t events = 4;
+
+    using sample = std::array<std::uint64_t, events>;
+
+    static auto names() noexcept -> const std::array<const char*, events>& {
+        static const std::array<const char*, events> out = {"cycles", "instructions", "cache-misses", "branch-misses"};
+        return out;
+    }
+
+    static auto local() noexcept -> perf_group& {
+        thread_local perf_group group = {};
+        return group;
+    }
+
+    perf_group(const perf_group&) = delete;
+    perf_group& operator=(const perf_group&) = delete;
+
+    ~perf_group() {
+        for (const int fd: m_fd) {
+            if (fd >= 0) {
+#if defined(__linux__)
+                ::close(fd);
+#endif
+            }
+        }
+    }
+
+    bool valid() const noexcept {
+        return m_fd.front() >= 0;
+    }
+
+    auto read() const noexcept -> sample {
+        sample out = {};
+#if defined(__linux__)
+        if (not valid()) {
+            return out;
+        }
+        std::array<std::uint64_t, events + 1> buf = {};
+        if (::read(m_fd.front(), buf.data(), sizeof(buf)) <= 0) {
+            return out;
+        }
+        for (std::size_t it{}, pos{1}; it < events and pos <= buf.front(); ++it) {
+            if (m_fd.at(it) >= 0) {
+                out.at(it) = buf.at(pos++);
+            }
+        }
+#endif
+        return out;
+    }
+
+private:
+    perf_group() noexcept {
+        m_fd.fill(-1);
+#if defined(__linux__)
+        constexpr std::array<std::uint64_t, events> config = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES,
+        };
+        for (std::size_t it{}; it < events; ++it) {
+            perf_event_attr attr = {};
+            attr.type           = PERF_TYPE_HARDWARE;
+            attr.size           = sizeof(attr);
+            attr.config         = config.at(it);
+            attr.read_format    = PERF_FORMAT_GROUP;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+
+            const int group = (it == 0) ? -1 : m_fd.front();
+            m_fd.at(it) = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+            if (m_fd.front() < 0) {
+                return;
+            }
+        }
+#endif
+    }
+
+    std::array<int, events> m_fd = {};
+};
+
+// Timer with hardware event counters registered under one name.
+struct perf_site {
+    histogram* time = nullptr;
+    std::array<counter*, perf_group::events> event = {};
+};
+
+// Name to metric mapping, references stay valid for program lifetime.
+class registry {
+public:
+    // Intentionally leaked so hooks stay usable from static destructors.
+    static auto instance() -> registry& {
+        static registry* const inst = new registry{};
+        return *inst;
+    }
+
+    auto counter_at(const std::string& name) -> counter& {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        return m_counters[name];
+    }
+
+    auto histogram_at(const std::string& name) -> histogram& {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        return m_histograms[name];
+    }
+
+    auto timer_at(const std::string& name) -> histogram& {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        return m_timers[name];
+    }
+
+    auto perf_site_at(const std::string& name) -> perf_site {
+        perf_site site = {};
+        site.time = &timer_at(name);
+        for (std::size_t it{}; it < perf_group::events; ++it) {
+            site.event.at(it) = &counter_at(name + "." + perf_group::names().at(it));
+        }
+        return site;
+    }
+
+    void dump(std::ostream& out) const {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+
+        out << "{\n  \"counters\": {";
+        bool first = true;
+        for (const auto& [name, cnt]: m_counters) {
+            out << (first ? "\n    " : ",\n    ");
+            detail::put_string(out, name);
+            out << ": " << cnt.value();
+            first = false;
+        }
+        out << "\n  },\n  \"histograms\": {";
+        dump_histograms(out, m_histograms);
+        out << "\n  },\n  \"timers_ns\": {";
+        dump_histograms(out, m_timers);
+        out << "\n  }\n}\n";
+    }
+
+private:
+    registry() {
+        std::atexit([]() {
+            if (not enabled()) {
+                return;
+            }
+            const char* const dest = detail::env_flag("PROBE");
+            if (dest and std::string{dest} != "1") {
+                std::ofstream out{dest};
+                registry::instance().dump(out);
+            } else {
+                registry::instance().dump(std::cerr);
+            }
+        });
+    }
+
+    static void dump_histograms(std::ostream& out, const std::map<std::string, histogram>& hists) {
+        bool first = true;
+        for (const auto& [name, hist]: hists) {
+            out << (first ? "\n    " : ",\n    ");
+            detail::put_string(out, name);
+            out << ": {\"count\": " << hist.count()
+                << ", \"sum\": "    << hist.sum()
+                << ", \"min\": "    << hist.min()
+                << ", \"max\": "    << hist.max()
+                << ", \"buckets\": {";
+            bool first_bucket = true;
+            for (std::size_t it{}; it < histogram::buckets; ++it) {
+                if (hist.bucket(it)) {
+                    // key is exclusive upper bound of bucket
+                    const auto upper = (it == 0) ? std::string{"1"}
+                                     : (it == 64) ? std::string{"18446744073709551616"}
+                                     : std::to_string(std::uint64_t{1} << it);
+                    out << (first_bucket ? "\"" : ", \"") << upper << "\": " << hist.bucket(it);
+                    first_bucket = false;
+                }
+            }
+            out << "}}";
+            first = false;
+        }
+    }
+
+    mutable std::mutex m_mutex = {};
+    std::map<std::string, counter>   m_counters   = {};
+    std::map<std::string, histogram> m_histograms = {};
+    std::map<std::string, histogram> m_timers     = {};
+};
+
+// RAII timer recording elapsed nanoseconds, no-op for nullptr.
+class scope {
+public:
+    explicit scope(histogram* const hist) noexcept
+        : m_hist{hist}, m_beg{hist ? detail::now_ns() : 0} {}
+
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+
+    ~scope() {
+        if (m_hist) {
+            m_hist->record(detail::now_ns() - m_beg);
+        }
+    }
+
+private:
+    histogram*    m_hist;
+    std::uint64_t m_beg;
+};
+
+// RAII timer that also accumulates hardware event deltas, no-op for nullptr.
+class perf_scope {
+public:
+    explicit perf_scope(const perf_site* const site) noexcept
+        : m_site{site}, m_perf{site and sampling()}, m_beg{}, m_ns{site ? detail::now_ns() : 0} {
+        if (m_perf) {
+            m_beg = perf_group::local().read();
+        }
+    }
+
+    perf_scope(const perf_scope&) = delete;
+    perf_scope& operator=(const perf_scope&) = delete;
+
+    ~perf_scope() {
+        if (not m_site) {
+            return;
+        }
+        m_site->time->record(detail::now_ns() - m_ns);
+        if (m_perf) {
+            const auto end = perf_group::local().read();
+            for (std::size_t it{}; it < perf_group::events; ++it) {
+                m_site->event.at(it)->add(end.at(it) - m_beg.at(it));
+            }
+        }
+    }
+
+    static bool sampling() noexcept {
+        static const bool flag = detail::env_flag("PROBE_PERF") != nullptr;
+        return flag and perf_group::local().valid();
+    }
+
+private:
+    const perf_site*   m_site;
+    bool               m_perf;
+    perf_group::sample m_beg;
+    std::uint64_t      m_ns;
+};
+
+}
+
+#define PROBE_CAT_(LHS, RHS) LHS##RHS
+#define PROBE_CAT(LHS, RHS) PROBE_CAT_(LHS, RHS)
+
+// Elapsed time of enclosing scope, NAME should be string literal.
+#define PROBE_SCOPE(NAME) \
+    const ::probe::scope PROBE_CAT(probe_scope_, __LINE__){::probe::enabled() ? &[]() -> ::probe::histogram& { \
+        static auto& site = ::probe::registry::instance().timer_at(NAME); \
+        return site; \
+    }() : nullptr}
+
+// Elapsed time and hardware events of enclosing scope, NAME should be string literal.
+#define PROBE_PERF_SCOPE(NAME) \
+    const ::probe::perf_scope PROBE_CAT(probe_scope_, __LINE__){::probe::enabled() ? &[]() -> const ::probe::perf_site& { \
+        static const auto site = ::probe::registry::instance().perf_site_at(NAME); \
+        return site; \
+    }() : nullptr}
+
+#define PROBE_COUNT(NAME, NUM) \
+    do { \
+        if (::probe::enabled()) { \
+            static auto& site = ::probe::registry::instance().counter_at(NAME); \
+            site.add(NUM); \
+        } \
+    } while (false)
+
+#define PROBE_RECORD(NAME, VALUE) \
+    do { \
+        if (::probe::enabled()) { \
+            static auto& site = ::probe::registry::instance().histogram_at(NAME); \
+            site.record(VALUE); \
+        } \
+    } while (false)
@@ -1,16 +1,36 @@
 #include <algorithm>
 #include <array>
+#include <cassert>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <map>
+#include <numeric>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <probe.hpp>
+
 namespace {
 
 constexpr uint8_t IP_OCTETS_NUM = 4U;
@@ -24,6 +44,25 @@ using ip_string_t = std::string;
 
 using stdinp_split_t = std::vector<std::string>;
 using stdout_print_t = std::function<bool(const ip_octets_t&)>;
+using stdout_check_t = std::vector<stdout_print_t>;
+
+// Index file layout: header, prefix offsets by first octet, unique addresses in
+// descending order, then per-address occurrence counts, all in host byte order.
+// Version 1 wrote the prefix table shifted by one bucket, version 2 had no byte
+// order mark, so such files are rejected rather than misread.
+constexpr std::array<char, 8> IP_INDEX_MAGIC = {'I', 'P', 'F', 'I', 'D', 'X', '\x00', '\x03'};
+constexpr uint64_t            IP_INDEX_ORDER = UINT64_C(0x0102030405060708);
+constexpr std::size_t         IP_PREFIX_NUM  = 256U + 1U;
+
+struct ip_index_head_t
+{
+    std::array<char, 8> magic  = IP_INDEX_MAGIC;
+    uint64_t            order  = IP_INDEX_ORDER;
+    uint64_t            unique = {};
+    uint64_t            total  = {};
+};
+
+using ip_prefix_t = std::array<uint32_t, IP_PREFIX_NUM>;
 
 // T(1), S(1)
 [[nodiscard]] ip_octets_t ip_into_octets(const ip_string_t& ip_string) noexcept
@@ -70,66 +109,1562 @@ using stdout_print_t = std::function<bool(const ip_octets_t&)>;
     return ip_idx;
 }
 
-// T(N*logN), S(N)
+// T(1), S(1)
+[[nodiscard]] ip_octets_t idx_to_octets(const ip_idx_t ip_idx) noexcept
+{
+    return ip_octets_t{
+        static_cast<uint16_t>((ip_idx >> 24) & 0xFF),
+        static_cast<uint16_t>((ip_idx >> 16) & 0xFF),
+        static_cast<uint16_t>((ip_idx >>  8) & 0xFF),
+        static_cast<uint16_t>((ip_idx >>  0) & 0xFF),
+    };
+}
+
+// T(1), S(1)
+[[nodiscard]] ip_octets_t parse_line(const std::string& line, stdinp_split_t& stdinp_split) noexcept
+{
+    boost::split(stdinp_split, line, [](const char symb) { return symb == '\t'; });
+    assert(stdinp_split.size() == 3);
+
+    return ip_into_octets(stdinp_split.at(0));
+}
+
+// T(N*logN), S(N): lines are parsed first and sorted after, so both stages are timed apart
 [[nodiscard]] ip_mapper_t parse_stdin() noexcept
 {
-    ip_mapper_t    ip_mapper    = {};
-    stdinp_split_t stdinp_split = {};
+    std::vector<ip_mapper_t::value_type> parsed = {};
 
-    for (std::string line; std::getline(std::cin, line);)
     {
-        boost::split(stdinp_split, line, [](const char symb) { return symb == '\t'; });
-        assert(stdinp_split.size() == 3);
+        PROBE_SCOPE("ip-filter.parse");
 
-        const ip_string_t ip_string = stdinp_split.at(0);
-        const ip_octets_t ip_octets = ip_into_octets(ip_string);
-        const ip_idx_t    ip_idx    = octets_to_idx (ip_octets);
+        stdinp_split_t stdinp_split = {};
 
-        ip_mapper.emplace(std::make_pair(ip_idx, ip_octets));
+        for (std::string line; std::getline(std::cin, line);)
+        {
+            const ip_octets_t ip_octets = parse_line(line, stdinp_split);
+            const ip_idx_t    ip_idx    = octets_to_idx(ip_octets);
+
+            parsed.emplace_back(ip_idx, ip_octets);
+            PROBE_COUNT("ip-filter.lines", 1);
+        }
     }
 
-    return ip_mapper;
+    PROBE_SCOPE("ip-filter.sort");
+
+    // equal keys keep input order, as with insertion while reading
+    return ip_mapper_t(parsed.cbegin(), parsed.cend());
 }
 
-// T(N), S(1)
+// T(N), S(N): matches are collected before printing, so predicate and output are timed apart
 void print_stdout(const ip_mapper_t& ip_mapper, const stdout_print_t& is_print) noexcept
 {
-    for (const auto& [__, ip_octets]: ip_mapper)
+    std::vector<const ip_octets_t*> matched = {};
+
+    {
+        PROBE_SCOPE("ip-filter.filter");
+
+        for (const auto& [__, ip_octets]: ip_mapper)
+        {
+            if (is_print(ip_octets))
+            {
+                matched.push_back(&ip_octets);
+            }
+        }
+    }
+
+    PROBE_SCOPE("ip-filter.print");
+
+    for (const auto* const ip_octets: matched)
+    {
+        std::cout << ip_from_octets(*ip_octets) << std::endl;
+    }
+}
+
+// Unique addresses in descending order with occurrence counts and first-octet offsets,
+// bucket k of the prefix table holds addresses with first octet (255 - k).
+struct ip_column_t
+{
+    const ip_idx_t* addrs  = nullptr;
+    const uint32_t* counts = nullptr;
+    const uint32_t* prefix = nullptr;
+    std::size_t     size   = {};
+
+    // T(1), S(1): positions of addresses with first octet in [lo, hi]
+    [[nodiscard]] std::pair<std::size_t, std::size_t> octet_range(const uint8_t lo, const uint8_t hi) const noexcept
+    {
+        assert(lo <= hi);
+        return {prefix[UINT8_MAX - hi], prefix[IP_PREFIX_NUM - 1 - lo]};
+    }
+};
+
+struct ip_packed_t
+{
+    std::vector<ip_idx_t> addrs  = {};
+    std::vector<uint32_t> counts = {};
+    ip_prefix_t           prefix = {};
+
+    // T(1), S(1): addresses come in non-increasing order, prefix holds bucket sizes until seal()
+    void append(const ip_idx_t ip_idx, const uint32_t count) noexcept
+    {
+        assert(addrs.empty() or addrs.back() >= ip_idx);
+
+        if (addrs.empty() or addrs.back() != ip_idx)
+        {
+            addrs.push_back(ip_idx);
+            counts.push_back(0);
+            prefix.at(IP_PREFIX_NUM - 1 - (ip_idx >> 24)) += 1;
+        }
+        counts.back() += count;
+    }
+
+    // T(1), S(1)
+    void seal() noexcept
+    {
+        std::partial_sum(prefix.cbegin(), prefix.cend(), prefix.begin());
+    }
+
+    [[nodiscard]] ip_column_t column() const noexcept
+    {
+        return ip_column_t{addrs.data(), counts.data(), prefix.data(), addrs.size()};
+    }
+};
+
+// T(N), S(N)
+[[nodiscard]] ip_packed_t pack_mapper(const ip_mapper_t& ip_mapper) noexcept
+{
+    PROBE_SCOPE("ip-filter.sort");
+
+    ip_packed_t ip_packed = {};
+
+    for (const auto& [ip_idx, __]: ip_mapper)
+    {
+        ip_packed.append(ip_idx, 1);
+    }
+    ip_packed.seal();
+
+    return ip_packed;
+}
+
+// T(N+M), S(N+M)
+[[nodiscard]] ip_packed_t merge_packed(const ip_packed_t& lhs, const ip_packed_t& rhs) noexcept
+{
+    PROBE_SCOPE("ip-filter.compact");
+
+    ip_packed_t ip_packed = {};
+    ip_packed.addrs .reserve(lhs.addrs.size() + rhs.addrs.size());
+    ip_packed.counts.reserve(lhs.addrs.size() + rhs.addrs.size());
+
+    std::size_t lit = 0;
+    std::size_t rit = 0;
+
+    while (lit < lhs.addrs.size() or rit < rhs.addrs.size())
+    {
+        const bool take_lhs = rit == rhs.addrs.size() or
+                              (lit < lhs.addrs.size() and lhs.addrs[lit] >= rhs.addrs[rit]);
+        if (take_lhs)
+        {
+            ip_packed.append(lhs.addrs[lit], lhs.counts[lit]);
+            ++lit;
+        }
+        else
+        {
+            ip_packed.append(rhs.addrs[rit], rhs.counts[rit]);
+            ++rit;
+        }
+    }
+    ip_packed.seal();
+
+    return ip_packed;
+}
+
+// Log-structured set of sorted runs: every batch lands as a new run, and the newest
+// run is compacted into the previous one once it reaches half of its size, so at most
+// O(logN) runs are kept and every address is merged O(logN) times.
+class ip_runs_t
+{
+public:
+    // T(B*logN), S(B) amortized
+    void insert(ip_packed_t ip_packed) noexcept
+    {
+        if (ip_packed.addrs.empty())
+        {
+            return;
+        }
+
+        m_runs.push_back(std::move(ip_packed));
+
+        while (m_runs.size() > 1 and
+               m_runs.at(m_runs.size() - 2).addrs.size() <= 2 * m_runs.back().addrs.size())
+        {
+            ip_packed_t newer = std::move(m_runs.back());
+            m_runs.pop_back();
+            m_runs.back() = merge_packed(m_runs.back(), newer);
+        }
+    }
+
+    // T(logN*logN), S(1): total occurrences across all runs
+    [[nodiscard]] uint32_t count(const ip_idx_t ip_idx) const noexcept
+    {
+        uint32_t total = 0;
+
+        for (const auto& run: m_runs)
+        {
+            const ip_column_t ip_column = run.column();
+            const auto  octet      = static_cast<uint8_t>(ip_idx >> 24);
+            const auto [beg, end]  = ip_column.octet_range(octet, octet);
+
+            const ip_idx_t* const last = ip_column.addrs + end;
+            const ip_idx_t* const iter = std::lower_bound(ip_column.addrs + beg, last, ip_idx, std::greater<ip_idx_t>{});
+
+            if (iter != last and *iter == ip_idx)
+            {
+                total += ip_column.counts[iter - ip_column.addrs];
+            }
+        }
+
+        return total;
+    }
+
+    [[nodiscard]] std::size_t runs() const noexcept
+    {
+        return m_runs.size();
+    }
+
+private:
+    std::vector<ip_packed_t> m_runs = {};
+};
+
+// T(N), S(1)
+[[nodiscard]] bool build_index(const ip_packed_t& ip_packed, const std::string& path) noexcept
+{
+    PROBE_SCOPE("ip-filter.index");
+
+    ip_index_head_t head = {};
+    head.unique = ip_packed.addrs.size();
+    head.total  = std::accumulate(ip_packed.counts.cbegin(), ip_packed.counts.cend(), uint64_t{0});
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+
+    out.write(reinterpret_cast<const char*>(&head),                   sizeof(head));
+    out.write(reinterpret_cast<const char*>(ip_packed.prefix.data()), sizeof(ip_prefix_t));
+    out.write(reinterpret_cast<const char*>(ip_packed.addrs.data()),  ip_packed.addrs.size()  * sizeof(ip_idx_t));
+    out.write(reinterpret_cast<const char*>(ip_packed.counts.data()), ip_packed.counts.size() * sizeof(uint32_t));
+
+    return static_cast<bool>(out.flush());
+}
+
+// Read-only view over memory-mapped index file.
+class ip_index_t
+{
+public:
+    explicit ip_index_t(const std::string& path) noexcept
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return;
+        }
+
+        struct stat info = {};
+        if (::fstat(fd, &info) == 0 and static_cast<std::size_t>(info.st_size) >= (sizeof(ip_index_head_t) + sizeof(ip_prefix_t)))
+        {
+            m_bytes = static_cast<std::size_t>(info.st_size);
+            m_map   = ::mmap(nullptr, m_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+
+        if (m_map == MAP_FAILED or m_map == nullptr)
+        {
+            m_map = nullptr;
+            return;
+        }
+
+        const auto* const base = static_cast<const char*>(m_map);
+        const auto* const head = reinterpret_cast<const ip_index_head_t*>(base);
+
+        constexpr std::size_t fixed = sizeof(ip_index_head_t) + sizeof(ip_prefix_t);
+        constexpr std::size_t entry = sizeof(ip_idx_t) + sizeof(uint32_t);
+
+        const bool fits = head->unique <= (std::numeric_limits<std::size_t>::max() - fixed) / entry;
+
+        if (head->magic != IP_INDEX_MAGIC or head->order != IP_INDEX_ORDER or not fits or
+            m_bytes != fixed + static_cast<std::size_t>(head->unique) * entry)
+        {
+            ::munmap(m_map, m_bytes);
+            m_map = nullptr;
+            return;
+        }
+
+        m_column.size   = head->unique;
+        m_column.prefix = reinterpret_cast<const uint32_t*>(base + sizeof(ip_index_head_t));
+        m_column.addrs  = reinterpret_cast<const ip_idx_t*>(base + fixed);
+        m_column.counts = reinterpret_cast<const uint32_t*>(m_column.addrs + m_column.size);
+
+        if (not consistent(head->total))
+        {
+            ::munmap(m_map, m_bytes);
+            m_map    = nullptr;
+            m_column = {};
+        }
+    }
+
+    ip_index_t(const ip_index_t&) = delete;
+    ip_index_t& operator=(const ip_index_t&) = delete;
+
+    ~ip_index_t()
+    {
+        if (m_map)
+        {
+            ::munmap(m_map, m_bytes);
+        }
+    }
+
+    [[nodiscard]] bool valid() const noexcept
+    {
+        return m_map != nullptr;
+    }
+
+    [[nodiscard]] const ip_column_t& column() const noexcept
+    {
+        return m_column;
+    }
+
+private:
+    // T(N), S(1): prefix table bounds every octet_range() inside the columns, counts add up to total
+    [[nodiscard]] bool consistent(const uint64_t total) const noexcept
+    {
+        const uint32_t* const prefix = m_column.prefix;
+
+        if (prefix[0] != 0 or prefix[IP_PREFIX_NUM - 1] != m_column.size)
+        {
+            return false;
+        }
+        for (std::size_t it = 1; it < IP_PREFIX_NUM; ++it)
+        {
+            if (prefix[it] < prefix[it - 1])
+            {
+                return false;
+            }
+        }
+
+        const uint64_t sum = std::accumulate(m_column.counts, m_column.counts + m_column.size, uint64_t{0});
+        return sum == total;
+    }
+
+    void*       m_map    = nullptr;
+    std::size_t m_bytes  = {};
+    ip_column_t m_column = {};
+};
+
+// T(N), S(1)
+void print_stdout(const ip_column_t& ip_column, const stdout_print_t& is_print) noexcept
+{
+    PROBE_SCOPE("ip-filter.print");
+
+    for (std::size_t it = 0; it < ip_column.size; ++it)
     {
+        const ip_octets_t ip_octets = idx_to_octets(ip_column.addrs[it]);
+
         if (is_print(ip_octets))
         {
-            std::cout << ip_from_octets(ip_octets) << std::endl;
+            const ip_string_t ip_string = ip_from_octets(ip_octets);
+
+            for (uint32_t num = 0; num < ip_column.counts[it]; ++num)
+            {
+                std::cout << ip_string << std::endl;
+            }
         }
     }
 }
 
+// T(1), S(1)
+template<typename T>
+[[nodiscard]] bool take_number(std::string_view& text, T& value) noexcept
+{
+    const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc{})
+    {
+        return false;
+    }
+    text.remove_prefix(static_cast<std::size_t>(ptr - text.data()));
+    return true;
 }
 
-int main()
+// T(1), S(1)
+[[nodiscard]] bool take_prefix(std::string_view& text, const std::string_view prefix) noexcept
 {
-    assert(ip_from_octets(ip_into_octets("127.0.0.1")) == "127.0.0.1");
-    assert(octets_to_idx (ip_into_octets("255.255.255.255")) == UINT32_MAX);
+    if (text.substr(0, prefix.size()) != prefix)
+    {
+        return false;
+    }
+    text.remove_prefix(prefix.size());
+    return true;
+}
 
-    const ip_mapper_t ip_mapper = parse_stdin();
+// T(1), S(1)
+[[nodiscard]] constexpr uint32_t cidr_mask(const uint8_t len) noexcept
+{
+    return (len == 0) ? 0 : (UINT32_MAX << (32 - len));
+}
 
-    print_stdout(ip_mapper, [](const ip_octets_t& ip_octets) -> bool {
-        (void) ip_octets;
+// T(1), S(1): "a.b.c.d[/len]", bare address is taken as /32
+[[nodiscard]] bool take_cidr(std::string_view text, ip_idx_t& net, uint8_t& len) noexcept
+{
+    ip_idx_t ip_idx = {};
+    for (uint8_t it = 0; it < IP_OCTETS_NUM; ++it)
+    {
+        uint8_t octet = {};
+        if ((it > 0 and not take_prefix(text, ".")) or not take_number(text, octet))
+        {
+            return false;
+        }
+        ip_idx = (ip_idx << 8) | octet;
+    }
+
+    len = 32;
+    if (take_prefix(text, "/") and (not take_number(text, len) or len > 32))
+    {
+        return false;
+    }
+
+    net = ip_idx & cidr_mask(len);
+    return text.empty();
+}
+
+struct ip_cidr_t
+{
+    ip_idx_t net = {};
+    uint8_t  len = {};
+};
+
+// Sorted disjoint address intervals covered by CIDR list, each tagged with the longest
+// covering prefix; jump table by upper 16 bits narrows lookups to few adjacent entries.
+class ip_cidr_set_t
+{
+public:
+    static constexpr std::size_t JUMP_NUM = (1U << 16) + 1U;
+
+    // T(N*logN), S(N): nested prefixes are split so inner ones take precedence
+    void build(std::vector<ip_cidr_t> cidrs) noexcept
+    {
+        PROBE_SCOPE("ip-filter.blocklist");
+
+        auto first = [](const ip_cidr_t& cidr) -> uint64_t { return cidr.net; };
+        auto last  = [](const ip_cidr_t& cidr) -> uint64_t { return uint64_t{cidr.net} | ~cidr_mask(cidr.len); };
+
+        std::sort(cidrs.begin(), cidrs.end(), [](const ip_cidr_t& lhs, const ip_cidr_t& rhs) {
+            return std::make_pair(lhs.net, lhs.len) < std::make_pair(rhs.net, rhs.len);
+        });
+        cidrs.erase(std::unique(cidrs.begin(), cidrs.end(), [](const ip_cidr_t& lhs, const ip_cidr_t& rhs) {
+            return lhs.net == rhs.net and lhs.len == rhs.len;
+        }), cidrs.end());
+
+        m_lo.clear();
+        m_hi.clear();
+        m_tag.clear();
+        m_cidrs = std::move(cidrs);
+
+        auto emit = [this](const uint64_t lo, const uint64_t hi, const std::size_t tag) {
+            if (lo <= hi)
+            {
+                m_lo.push_back(static_cast<ip_idx_t>(lo));
+                m_hi.push_back(static_cast<ip_idx_t>(hi));
+                m_tag.push_back(static_cast<uint32_t>(tag));
+            }
+        };
+
+        // CIDR blocks are either nested or disjoint, so open blocks form a stack
+        std::vector<std::size_t> stack  = {};
+        uint64_t                 cursor = 0;
+
+        for (std::size_t it = 0; it <= m_cidrs.size(); ++it)
+        {
+            const uint64_t next = (it < m_cidrs.size()) ? first(m_cidrs.at(it)) : (uint64_t{UINT32_MAX} + 1);
+
+            while (not stack.empty() and last(m_cidrs.at(stack.back())) < next)
+            {
+                emit(cursor, last(m_cidrs.at(stack.back())), stack.back());
+                cursor = last(m_cidrs.at(stack.back())) + 1;
+                stack.pop_back();
+            }
+            // nested prefix starting where the enclosing one does leaves no gap before it
+            if (not stack.empty() and next > cursor)
+            {
+                emit(cursor, next - 1, stack.back());
+            }
+            if (it < m_cidrs.size())
+            {
+                cursor = next;
+                stack.push_back(it);
+            }
+        }
+
+        m_jump.assign(JUMP_NUM, static_cast<uint32_t>(m_lo.size()));
+        for (std::size_t key = 0, pos = 0; key + 1 < JUMP_NUM; ++key)
+        {
+            while (pos < m_hi.size() and (m_hi.at(pos) >> 16) < key)
+            {
+                ++pos;
+            }
+            m_jump.at(key) = static_cast<uint32_t>(pos);
+        }
+    }
+
+    // T(N*logN), S(N): one CIDR per line, blank lines and '#' comments are skipped
+    [[nodiscard]] bool load(const std::string& path, std::string& error) noexcept
+    {
+        std::ifstream inp(path);
+        if (not inp)
+        {
+            error = "failed to open " + path;
+            return false;
+        }
+
+        std::vector<ip_cidr_t> cidrs = {};
+
+        std::size_t num = 0;
+        for (std::string line; std::getline(inp, line);)
+        {
+            ++num;
+            boost::trim(line);
+            if (line.empty() or line.front() == '#')
+            {
+                continue;
+            }
+
+            ip_cidr_t cidr = {};
+            if (not take_cidr(line, cidr.net, cidr.len))
+            {
+                error = path + ":" + std::to_string(num) + ": bad network '" + line + "'";
+                return false;
+            }
+            cidrs.push_back(cidr);
+        }
+
+        build(std::move(cidrs));
         return true;
-    });
+    }
 
-    print_stdout(ip_mapper, [](const ip_octets_t& ip_octets) -> bool {
-        return ip_octets.at(0) == 1;
-    });
+    // T(logK), S(1): longest prefix covering address or nullptr, K is intervals per 64K block
+    [[nodiscard]] const ip_cidr_t* lookup(const ip_idx_t ip_idx) const noexcept
+    {
+        if (m_lo.empty())
+        {
+            return nullptr;
+        }
 
-    print_stdout(ip_mapper, [](const ip_octets_t& ip_octets) -> bool {
-        return ip_octets.at(0) == 46 and
-               ip_octets.at(1) == 70;
-    });
+        const std::size_t key = ip_idx >> 16;
+        const std::size_t beg = m_jump[key];
+        const std::size_t end = std::min<std::size_t>(m_jump[key + 1] + 1, m_lo.size());
 
-    print_stdout(ip_mapper, [](const ip_octets_t& ip_octets) -> bool {
-        return ip_octets.at(0) == 46 or
-               ip_octets.at(1) == 46 or
-               ip_octets.at(2) == 46 or
-               ip_octets.at(3) == 46;
-    });
+        const auto pos = static_cast<std::size_t>(
+            std::upper_bound(m_lo.cbegin() + beg, m_lo.cbegin() + end, ip_idx) - m_lo.cbegin());
+
+        if (pos == 0 or m_hi[pos - 1] < ip_idx)
+        {
+            return nullptr;
+        }
+        return &m_cidrs[m_tag[pos - 1]];
+    }
+
+    // T(N+K), S(1): merge walk over addresses in non-increasing order, on_match(it, cidr) for listed ones;
+    // starts from the jump table bucket of addrs[0], so K counts only intervals down to addrs[num-1]
+    template<typename Fn>
+    void walk_sorted(const ip_idx_t* const addrs, const std::size_t num, Fn&& on_match) const noexcept
+    {
+        if (num == 0 or m_lo.empty())
+        {
+            return;
+        }
+
+        std::size_t pos = std::min<std::size_t>(m_jump[(addrs[0] >> 16) + 1] + 1, m_lo.size());
+
+        for (std::size_t it = 0; it < num; ++it)
+        {
+            assert(it == 0 or addrs[it - 1] >= addrs[it]);
+
+            while (pos > 0 and m_lo[pos - 1] > addrs[it])
+            {
+                --pos;
+            }
+            if (pos > 0 and addrs[it] <= m_hi[pos - 1])
+            {
+                on_match(it, m_cidrs[m_tag[pos - 1]]);
+            }
+        }
+    }
+
+    [[nodiscard]] bool contains(const ip_idx_t ip_idx) const noexcept
+    {
+        return lookup(ip_idx) != nullptr;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return m_lo.empty();
+    }
+
+    [[nodiscard]] ip_idx_t front() const noexcept
+    {
+        return m_lo.front();
+    }
+
+    [[nodiscard]] ip_idx_t back() const noexcept
+    {
+        return m_hi.back();
+    }
+
+private:
+    std::vector<ip_idx_t>  m_lo    = {};
+    std::vector<ip_idx_t>  m_hi    = {};
+    std::vector<uint32_t>  m_tag   = {};
+    std::vector<uint32_t>  m_jump  = {};
+    std::vector<ip_cidr_t> m_cidrs = {};
+};
+
+// Filter program: tests and boolean ops in reverse polish notation, every test
+// holds when lo <= (value & mask) <= hi for address or occurrence count, list test
+// holds for addresses covered by blocklist within [lo, hi].
+enum class ip_op_t : uint8_t
+{
+    TEST_ADDR,
+    TEST_COUNT,
+    TEST_LIST,
+    AND,
+    OR,
+    NOT,
+};
+
+struct ip_instr_t
+{
+    ip_op_t  op   = ip_op_t::TEST_ADDR;
+    uint32_t mask = {};
+    uint32_t lo   = {};
+    uint32_t hi   = {};
+};
+
+struct ip_program_t
+{
+    std::vector<ip_instr_t> code      = {};
+    const ip_cidr_set_t*    blocklist = nullptr;
+    std::size_t             depth     = {};
+    uint8_t                 octet_lo  = 0;
+    uint8_t                 octet_hi  = UINT8_MAX;
+    bool                    never     = false;
+};
+
+using ip_filters_t = std::vector<ip_program_t>;
+
+constexpr std::size_t IP_BLOCK_NUM = 256U;
+
+// Recursive descent parser of filter expressions:
+//   expr   := term {"or" term}
+//   term   := factor {"and" factor}
+//   factor := "not" factor | "(" expr ")" | atom
+//   atom   := "all" | oN=V[-V] | any=V[-V] | "in" a.b.c.d[/len] | count(=|<|>|<=|>=)N | "listed"
+class ip_parser_t
+{
+public:
+    explicit ip_parser_t(const std::string& text, const ip_cidr_set_t* const blocklist = nullptr) noexcept
+        : m_blocklist(blocklist)
+    {
+        std::string token = {};
+        for (const char symb: text)
+        {
+            if (symb == ' ' or symb == '\t' or symb == '(' or symb == ')')
+            {
+                if (not token.empty())
+                {
+                    m_tokens.push_back(std::move(token));
+                    token.clear();
+                }
+                if (symb == '(' or symb == ')')
+                {
+                    m_tokens.emplace_back(1, symb);
+                }
+                continue;
+            }
+            token.push_back(symb);
+        }
+        if (not token.empty())
+        {
+            m_tokens.push_back(std::move(token));
+        }
+    }
+
+    // T(N), S(N)
+    [[nodiscard]] bool parse(ip_program_t& program) noexcept
+    {
+        parse_expr();
+
+        if (m_error.empty() and m_pos != m_tokens.size())
+        {
+            fail("unexpected '" + m_tokens.at(m_pos) + "'");
+        }
+        if (not m_error.empty())
+        {
+            return false;
+        }
+
+        program = link(std::move(m_code));
+        program.blocklist = m_blocklist;
+        return true;
+    }
+
+    [[nodiscard]] const std::string& error() const noexcept
+    {
+        return m_error;
+    }
+
+private:
+    [[nodiscard]] bool done() const noexcept
+    {
+        return not m_error.empty() or m_pos == m_tokens.size();
+    }
+
+    [[nodiscard]] bool accept(const std::string_view token) noexcept
+    {
+        if (done() or m_tokens.at(m_pos) != token)
+        {
+            return false;
+        }
+        ++m_pos;
+        return true;
+    }
+
+    void fail(std::string error) noexcept
+    {
+        if (m_error.empty())
+        {
+            m_error = std::move(error);
+        }
+    }
+
+    void emit(const ip_op_t op, const uint32_t mask = {}, const uint32_t lo = {}, const uint32_t hi = {}) noexcept
+    {
+        m_code.push_back(ip_instr_t{op, mask, lo, hi});
+    }
+
+    void parse_expr() noexcept
+    {
+        parse_term();
+        while (accept("or"))
+        {
+            parse_term();
+            emit(ip_op_t::OR);
+        }
+    }
+
+    void parse_term() noexcept
+    {
+        parse_factor();
+        while (accept("and"))
+        {
+            parse_factor();
+            emit(ip_op_t::AND);
+        }
+    }
+
+    void parse_factor() noexcept
+    {
+        if (done())
+        {
+            fail("unexpected end of filter");
+            return;
+        }
+        if (accept("not"))
+        {
+            parse_factor();
+            emit(ip_op_t::NOT);
+            return;
+        }
+        if (accept("("))
+        {
+            parse_expr();
+            if (not accept(")"))
+            {
+                fail("missing ')'");
+            }
+            return;
+        }
+        parse_atom(m_tokens.at(m_pos++));
+    }
+
+    void parse_atom(const std::string& token) noexcept
+    {
+        std::string_view text = token;
+
+        if (text == "all")
+        {
+            emit(ip_op_t::TEST_ADDR, 0, 0, 0);
+            return;
+        }
+
+        if (text == "listed")
+        {
+            if (m_blocklist == nullptr)
+            {
+                fail("'listed' requires --blocklist");
+                return;
+            }
+            if (m_blocklist->empty())
+            {
+                emit(ip_op_t::TEST_LIST, 0, 1, 0);
+                return;
+            }
+            emit(ip_op_t::TEST_LIST, 0, m_blocklist->front(), m_blocklist->back());
+            return;
+        }
+
+        if (text == "in")
+        {
+            if (done())
+            {
+                fail("missing network after 'in'");
+                return;
+            }
+            parse_cidr(m_tokens.at(m_pos++));
+            return;
+        }
+
+        if (take_prefix(text, "any="))
+        {
+            uint8_t lo = {};
+            uint8_t hi = {};
+            if (not parse_octets(text, lo, hi))
+            {
+                fail("bad octet range in '" + token + "'");
+                return;
+            }
+            for (uint32_t octet = 0; octet < IP_OCTETS_NUM; ++octet)
+            {
+                const uint32_t shift = (IP_OCTETS_NUM - 1 - octet) * 8;
+                emit(ip_op_t::TEST_ADDR, UINT32_C(0xFF) << shift, uint32_t{lo} << shift, uint32_t{hi} << shift);
+                if (octet > 0)
+                {
+                    emit(ip_op_t::OR);
+                }
+            }
+            return;
+        }
+
+        if (take_prefix(text, "count"))
+        {
+            parse_count(text, token);
+            return;
+        }
+
+        uint8_t octet = {};
+        if (take_prefix(text, "o") and take_number(text, octet) and
+            octet >= 1 and octet <= IP_OCTETS_NUM and take_prefix(text, "="))
+        {
+            uint8_t lo = {};
+            uint8_t hi = {};
+            if (not parse_octets(text, lo, hi))
+            {
+                fail("bad octet range in '" + token + "'");
+                return;
+            }
+            const uint32_t shift = (IP_OCTETS_NUM - octet) * 8U;
+            emit(ip_op_t::TEST_ADDR, UINT32_C(0xFF) << shift, uint32_t{lo} << shift, uint32_t{hi} << shift);
+            return;
+        }
+
+        fail("unknown term '" + token + "'");
+    }
+
+    [[nodiscard]] static bool parse_octets(std::string_view text, uint8_t& lo, uint8_t& hi) noexcept
+    {
+        if (not take_number(text, lo))
+        {
+            return false;
+        }
+        hi = lo;
+        if (take_prefix(text, "-") and not take_number(text, hi))
+        {
+            return false;
+        }
+        return text.empty() and lo <= hi;
+    }
+
+    void parse_cidr(const std::string& token) noexcept
+    {
+        ip_idx_t net = {};
+        uint8_t  len = {};
+
+        if (not take_cidr(token, net, len))
+        {
+            fail("bad network '" + token + "'");
+            return;
+        }
+
+        emit(ip_op_t::TEST_ADDR, cidr_mask(len), net, net);
+    }
+
+    void parse_count(std::string_view text, const std::string& token) noexcept
+    {
+        const bool le = take_prefix(text, "<=");
+        const bool ge = not le and take_prefix(text, ">=");
+        const bool lt = not le and not ge and take_prefix(text, "<");
+        const bool gt = not le and not ge and not lt and take_prefix(text, ">");
+        const bool eq = not le and not ge and not lt and not gt and take_prefix(text, "=");
+
+        uint32_t num = {};
+        if (not (le or ge or lt or gt or eq) or not take_number(text, num) or not text.empty())
+        {
+            fail("bad count condition '" + token + "'");
+            return;
+        }
+
+        uint64_t lo = 0;
+        uint64_t hi = UINT32_MAX;
+
+        if (eq) { lo = num; hi = num; }
+        if (le) { hi = num; }
+        if (ge) { lo = num; }
+        if (lt) { hi = uint64_t{num} - 1; }
+        if (gt) { lo = uint64_t{num} + 1; }
+
+        if ((lt and num == 0) or (gt and num == UINT32_MAX))
+        {
+            lo = 1;
+            hi = 0;
+        }
+
+        emit(ip_op_t::TEST_COUNT, UINT32_MAX, static_cast<uint32_t>(lo), static_cast<uint32_t>(hi));
+    }
+
+    // T(N), S(N): stack depth and conservative first-octet bounds of compiled program
+    [[nodiscard]] static ip_program_t link(std::vector<ip_instr_t> code) noexcept
+    {
+        using bounds_t = std::pair<int, int>;
+
+        constexpr bounds_t ANY   = {0, UINT8_MAX};
+        constexpr bounds_t EMPTY = {1, 0};
+
+        std::vector<bounds_t> stack = {};
+        std::size_t           depth = {};
+
+        for (const auto& instr: code)
+        {
+            switch (instr.op)
+            {
+            case ip_op_t::TEST_ADDR:
+            case ip_op_t::TEST_LIST:
+                if (instr.op == ip_op_t::TEST_ADDR and (instr.mask >> 24) != UINT8_MAX)
+                {
+                    stack.push_back(ANY);
+                }
+                else if (instr.lo > instr.hi)
+                {
+                    stack.push_back(EMPTY);
+                }
+                else
+                {
+                    stack.emplace_back(static_cast<int>(instr.lo >> 24), static_cast<int>(instr.hi >> 24));
+                }
+                break;
+            case ip_op_t::TEST_COUNT:
+                stack.push_back(ANY);
+                break;
+            case ip_op_t::NOT:
+                stack.back() = ANY;
+                break;
+            case ip_op_t::AND:
+            case ip_op_t::OR:
+            {
+                const bounds_t rhs = stack.back();
+                stack.pop_back();
+                bounds_t& lhs = stack.back();
+
+                if (instr.op == ip_op_t::AND)
+                {
+                    lhs = {std::max(lhs.first, rhs.first), std::min(lhs.second, rhs.second)};
+                }
+                else if (lhs.first > lhs.second)
+                {
+                    lhs = rhs;
+                }
+                else if (rhs.first <= rhs.second)
+                {
+                    lhs = {std::min(lhs.first, rhs.first), std::max(lhs.second, rhs.second)};
+                }
+                break;
+            }
+            }
+            depth = std::max(depth, stack.size());
+        }
+        assert(stack.size() == 1);
+
+        ip_program_t program = {};
+        program.code     = std::move(code);
+        program.depth    = depth;
+        program.never    = stack.back().first > stack.back().second;
+        program.octet_lo = static_cast<uint8_t>(program.never ? 0 : stack.back().first);
+        program.octet_hi = static_cast<uint8_t>(program.never ? 0 : stack.back().second);
+
+        return program;
+    }
+
+    std::vector<std::string> m_tokens    = {};
+    std::size_t              m_pos       = {};
+    std::vector<ip_instr_t>  m_code      = {};
+    std::string              m_error     = {};
+    const ip_cidr_set_t*     m_blocklist = nullptr;
+};
+
+// T(N), S(N)
+[[nodiscard]] bool compile_filter(const std::string& text, ip_program_t& program, std::string& error,
+                                  const ip_cidr_set_t* const blocklist = nullptr) noexcept
+{
+    ip_parser_t ip_parser(text, blocklist);
+
+    if (not ip_parser.parse(program))
+    {
+        error = ip_parser.error();
+        return false;
+    }
+    return true;
+}
+
+// T(N), S(1): branch-free compare over block, vectorized by compiler
+void eval_test(uint8_t* const out, const uint32_t* const values, const std::size_t num, const ip_instr_t& instr) noexcept
+{
+    const uint32_t mask = instr.mask;
+    const uint32_t lo   = instr.lo;
+    const uint32_t hi   = instr.hi;
+
+    for (std::size_t it = 0; it < num; ++it)
+    {
+        const uint32_t value = values[it] & mask;
+        out[it] = static_cast<uint8_t>((value >= lo) & (value <= hi));
+    }
+}
+
+using ip_block_t = std::array<uint8_t, IP_BLOCK_NUM>;
+using ip_stack_t = std::vector<ip_block_t>;
+
+// T(B*P), S(1): match flags of B <= IP_BLOCK_NUM addresses in non-increasing order are left in stack[0]
+void eval_block(const ip_program_t& program, const ip_idx_t* const addrs, const uint32_t* const counts,
+                const std::size_t num, ip_stack_t& stack) noexcept
+{
+    assert(num <= IP_BLOCK_NUM and stack.size() >= program.depth);
+    PROBE_SCOPE("ip-filter.filter");
+
+    std::size_t top = 0;
+    for (const auto& instr: program.code)
+    {
+        switch (instr.op)
+        {
+        case ip_op_t::TEST_ADDR:
+            eval_test(stack[top++].data(), addrs, num, instr);
+            break;
+        case ip_op_t::TEST_COUNT:
+            eval_test(stack[top++].data(), counts, num, instr);
+            break;
+        case ip_op_t::TEST_LIST:
+            std::fill_n(stack[top].data(), num, uint8_t{0});
+            program.blocklist->walk_sorted(addrs, num, [&block = stack[top]](const std::size_t it, const ip_cidr_t&) {
+                block[it] = 1U;
+            });
+            ++top;
+            break;
+        case ip_op_t::AND:
+            --top;
+            for (std::size_t it = 0; it < num; ++it)
+            {
+                stack[top - 1][it] &= stack[top][it];
+            }
+            break;
+        case ip_op_t::OR:
+            --top;
+            for (std::size_t it = 0; it < num; ++it)
+            {
+                stack[top - 1][it] |= stack[top][it];
+            }
+            break;
+        case ip_op_t::NOT:
+            for (std::size_t it = 0; it < num; ++it)
+            {
+                stack[top - 1][it] ^= 1U;
+            }
+            break;
+        }
+    }
+    assert(top == 1);
+}
+
+// T(N*P), S(P): program P is evaluated over blocks of addresses within its first-octet bounds
+void print_stdout(const ip_column_t& ip_column, const ip_program_t& program) noexcept
+{
+    PROBE_PERF_SCOPE("ip-filter.print");
+
+    if (program.never or ip_column.size == 0)
+    {
+        return;
+    }
+
+    ip_stack_t stack(program.depth);
+
+    const auto [beg, end] = ip_column.octet_range(program.octet_lo, program.octet_hi);
+
+    for (std::size_t base = beg; base < end; base += IP_BLOCK_NUM)
+    {
+        const std::size_t     num    = std::min(IP_BLOCK_NUM, end - base);
+        const ip_idx_t* const addrs  = ip_column.addrs  + base;
+        const uint32_t* const counts = ip_column.counts + base;
+
+        eval_block(program, addrs, counts, num, stack);
+
+        for (std::size_t it = 0; it < num; ++it)
+        {
+            if (stack[0][it])
+            {
+                const ip_string_t ip_string = ip_from_octets(idx_to_octets(addrs[it]));
+
+                for (uint32_t cnt = 0; cnt < counts[it]; ++cnt)
+                {
+                    std::cout << ip_string << std::endl;
+                }
+            }
+        }
+    }
+}
+
+// T(N+M), S(1): "<ip>\t<net>/<len>" for every occurrence of listed address
+void print_listed(const ip_column_t& ip_column, const ip_cidr_set_t& blocklist) noexcept
+{
+    PROBE_SCOPE("ip-filter.print");
+
+    blocklist.walk_sorted(ip_column.addrs, ip_column.size, [&ip_column](const std::size_t it, const ip_cidr_t& cidr) {
+        const ip_string_t ip_string = ip_from_octets(idx_to_octets(ip_column.addrs[it]));
+        const ip_string_t ip_prefix = ip_from_octets(idx_to_octets(cidr.net));
+
+        for (uint32_t cnt = 0; cnt < ip_column.counts[it]; ++cnt)
+        {
+            std::cout << ip_string << '\t' << ip_prefix << '/' << static_cast<unsigned>(cidr.len) << std::endl;
+        }
+    });
+}
+
+[[nodiscard]] stdout_check_t builtin_checks() noexcept
+{
+    stdout_check_t checks = {};
+
+    checks.emplace_back([](const ip_octets_t& ip_octets) -> bool {
+        (void) ip_octets;
+        return true;
+    });
+
+    checks.emplace_back([](const ip_octets_t& ip_octets) -> bool {
+        return ip_octets.at(0) == 1;
+    });
+
+    checks.emplace_back([](const ip_octets_t& ip_octets) -> bool {
+        return ip_octets.at(0) == 46 and
+               ip_octets.at(1) == 70;
+    });
+
+    checks.emplace_back([](const ip_octets_t& ip_octets) -> bool {
+        return ip_octets.at(0) == 46 or
+               ip_octets.at(1) == 46 or
+               ip_octets.at(2) == 46 or
+               ip_octets.at(3) == 46;
+    });
+
+    return checks;
+}
+
+constexpr std::size_t               IP_FOLLOW_BATCH = 1U << 16;
+constexpr std::chrono::milliseconds IP_FOLLOW_POLL  = std::chrono::milliseconds(200);
+
+// set by SIGINT/SIGTERM, follow_file() returns at the next batch or poll
+volatile std::sig_atomic_t ip_follow_stop = 0;
+
+void stop_following(const int) noexcept
+{
+    ip_follow_stop = 1;
+}
+
+// T(1), S(1): "<query>\t<+|-><occurrences>\t<ip>"
+void print_delta(const std::size_t query, const char sign, const uint32_t num, const ip_idx_t ip_idx) noexcept
+{
+    std::cout << query << '\t' << sign << num << '\t' << ip_from_octets(idx_to_octets(ip_idx)) << std::endl;
+}
+
+// T(B*logN*logN + B*P), S(B): results of registered queries change only at addresses of new batch
+void apply_batch(ip_runs_t& ip_runs, std::vector<ip_idx_t>& batch,
+                 const stdout_check_t& checks, const ip_filters_t& ip_filters) noexcept
+{
+    PROBE_SCOPE("ip-filter.follow.batch");
+    PROBE_COUNT("ip-filter.lines", batch.size());
+
+    std::sort(batch.begin(), batch.end(), std::greater<ip_idx_t>{});
+
+    ip_packed_t fresh = {};
+    for (const ip_idx_t ip_idx: batch)
+    {
+        fresh.append(ip_idx, 1);
+    }
+    fresh.seal();
+    batch.clear();
+
+    const std::size_t size = fresh.addrs.size();
+
+    std::vector<uint32_t> before(size);
+    std::vector<uint32_t> after (size);
+
+    for (std::size_t it = 0; it < size; ++it)
+    {
+        before.at(it) = ip_runs.count(fresh.addrs.at(it));
+        after .at(it) = before.at(it) + fresh.counts.at(it);
+    }
+
+    for (std::size_t query = 0; query < checks.size(); ++query)
+    {
+        for (std::size_t it = 0; it < size; ++it)
+        {
+            if (checks.at(query)(idx_to_octets(fresh.addrs.at(it))))
+            {
+                print_delta(query, '+', fresh.counts.at(it), fresh.addrs.at(it));
+            }
+        }
+    }
+
+    ip_stack_t stack_before = {};
+    ip_stack_t stack_after  = {};
+
+    for (std::size_t query = 0; query < ip_filters.size(); ++query)
+    {
+        const ip_program_t& program = ip_filters.at(query);
+
+        stack_before.resize(program.depth);
+        stack_after .resize(program.depth);
+
+        for (std::size_t base = 0; base < size; base += IP_BLOCK_NUM)
+        {
+            const std::size_t num = std::min(IP_BLOCK_NUM, size - base);
+
+            eval_block(program, fresh.addrs.data() + base, before.data() + base, num, stack_before);
+            eval_block(program, fresh.addrs.data() + base, after .data() + base, num, stack_after);
+
+            for (std::size_t it = 0; it < num; ++it)
+            {
+                const bool was = stack_before[0][it] and before[base + it] > 0;
+                const bool now = stack_after [0][it];
+
+                if (was and now)
+                {
+                    print_delta(checks.size() + query, '+', fresh.counts[base + it], fresh.addrs[base + it]);
+                }
+                if (not was and now)
+                {
+                    print_delta(checks.size() + query, '+', after[base + it], fresh.addrs[base + it]);
+                }
+                if (was and not now)
+                {
+                    print_delta(checks.size() + query, '-', before[base + it], fresh.addrs[base + it]);
+                }
+            }
+        }
+    }
+
+    ip_runs.insert(std::move(fresh));
+}
+
+// T(B*logN*logN) per batch of B lines, S(N): tails appending log until stop_following() is called
+[[nodiscard]] bool follow_file(const std::string& path, const stdout_check_t& checks, const ip_filters_t& ip_filters) noexcept
+{
+    std::ifstream inp(path);
+    if (not inp)
+    {
+        return false;
+    }
+
+    ip_runs_t             ip_runs      = {};
+    std::vector<ip_idx_t> batch        = {};
+    stdinp_split_t        stdinp_split = {};
+    std::string           pending      = {};
+
+    for (std::string line; not ip_follow_stop;)
+    {
+        while (batch.size() < IP_FOLLOW_BATCH and std::getline(inp, line))
+        {
+            pending += line;
+            if (inp.eof())
+            {
+                break;
+            }
+            if (not pending.empty())
+            {
+                batch.push_back(octets_to_idx(parse_line(pending, stdinp_split)));
+            }
+            pending.clear();
+        }
+
+        if (not batch.empty())
+        {
+            apply_batch(ip_runs, batch, checks, ip_filters);
+        }
+
+        if (inp.eof() or inp.fail())
+        {
+            inp.clear();
+            std::this_thread::sleep_for(IP_FOLLOW_POLL);
+        }
+    }
+    return true;
+}
+
+#ifndef NDEBUG
+// T(1), S(1): checks of parsing, filter compilation and blocklist lookups, debug builds only
+void self_test() noexcept
+{
+    assert(ip_from_octets(ip_into_octets("127.0.0.1")) == "127.0.0.1");
+    assert(octets_to_idx (ip_into_octets("255.255.255.255")) == UINT32_MAX);
+
+    {
+        ip_program_t program = {};
+        std::string  error   = {};
+
+        assert(compile_filter("o1=46 and o2=70", program, error) and program.code.size() == 3);
+        assert(program.octet_lo == 46 and program.octet_hi == 46);
+        assert(compile_filter("not (o1=1-9 or in 10.0.0.0/8) and count>=2", program, error));
+        assert(program.octet_lo == 0 and program.octet_hi == UINT8_MAX);
+        assert(compile_filter("o1=1 and o1=2", program, error) and program.never);
+        assert(not compile_filter("o5=1", program, error));
+        assert(not compile_filter("o1=256", program, error));
+        assert(not compile_filter("in 10.0.0.0/33", program, error));
+        assert(not compile_filter("(all", program, error));
+        assert(not compile_filter("listed", program, error));
+    }
+
+    {
+        ip_cidr_set_t ip_cidr_set = {};
+        ip_cidr_set.build({{octets_to_idx({10, 0, 0, 0}),  8}, {octets_to_idx({10, 1, 0, 0}), 16},
+                           {octets_to_idx({10, 1, 2, 3}), 32}, {octets_to_idx({255, 255, 255, 0}), 24}});
+
+        assert(ip_cidr_set.lookup(octets_to_idx({10, 1, 2, 3}))->len == 32);
+        assert(ip_cidr_set.lookup(octets_to_idx({10, 1, 2, 4}))->len == 16);
+        assert(ip_cidr_set.lookup(octets_to_idx({10, 2, 0, 0}))->len ==  8);
+        assert(ip_cidr_set.lookup(UINT32_MAX)->len == 24);
+        assert(not ip_cidr_set.contains(octets_to_idx({11, 0, 0, 0})));
+        assert(not ip_cidr_set.contains(octets_to_idx({9, 255, 255, 255})));
+
+        const std::array<ip_idx_t, 4> addrs = {UINT32_MAX, octets_to_idx({11, 0, 0, 0}),
+                                               octets_to_idx({10, 1, 2, 3}), octets_to_idx({10, 1, 2, 2})};
+        std::array<uint8_t, 4> lens = {};
+        ip_cidr_set.walk_sorted(addrs.data(), addrs.size(), [&lens](const std::size_t it, const ip_cidr_t& cidr) {
+            lens.at(it) = cidr.len;
+        });
+        assert((lens == std::array<uint8_t, 4>{24, 0, 32, 16}));
+
+        const std::array<ip_idx_t, 2> tail = {octets_to_idx({10, 1, 2, 4}), octets_to_idx({10, 0, 0, 1})};
+        std::array<uint8_t, 2> tail_lens = {};
+        ip_cidr_set.walk_sorted(tail.data(), tail.size(), [&tail_lens](const std::size_t it, const ip_cidr_t& cidr) {
+            tail_lens.at(it) = cidr.len;
+        });
+        assert((tail_lens == std::array<uint8_t, 2>{16, 8}));
+    }
+
+    {
+        ip_cidr_set_t ip_cidr_set = {};
+        ip_cidr_set.build({{0, 8}, {0, 16}});
+
+        assert(ip_cidr_set.lookup(octets_to_idx({0, 0, 1, 1}))->len == 16);
+        assert(ip_cidr_set.lookup(octets_to_idx({0, 1, 0, 0}))->len ==  8);
+        assert(not ip_cidr_set.contains(octets_to_idx({200, 1, 1, 1})));
+        assert(not ip_cidr_set.contains(UINT32_MAX));
+
+        const std::array<ip_idx_t, 3> addrs = {octets_to_idx({200, 1, 1, 1}), octets_to_idx({0, 1, 0, 0}), 5};
+        std::array<uint8_t, 3> lens = {};
+        ip_cidr_set.walk_sorted(addrs.data(), addrs.size(), [&lens](const std::size_t it, const ip_cidr_t& cidr) {
+            lens.at(it) = cidr.len;
+        });
+        assert((lens == std::array<uint8_t, 3>{0, 8, 16}));
+    }
+}
+#endif
+
+}
+
+// Usage:
+//   ip-filter                      < dump.tsv  print built-in filters
+//   ip-filter --build-index <file> < dump.tsv  store parsed dump as binary index
+//   ip-filter --query <file>                   print built-in filters from index
+//   ip-filter [--query <file>] --filter <expr> [--filter <expr> ...]
+//                                              print user-defined filters in given order,
+//                                              e.g. --filter "o1=46 and (o2=70 or in 46.0.0.0/8)"
+//   ip-filter --follow <file> [--filter <expr> ...]
+//                                              tail appending dump until SIGINT/SIGTERM, print result
+//                                              deltas of built-in or user-defined filters per batch
+//   ip-filter [--query <file>] --blocklist <file> [--filter <expr> ...]
+//                                              enable "listed" term in filters, without filters
+//                                              print listed addresses with longest matching prefix
+int main(int argc, char* argv[])
+{
+#ifndef NDEBUG
+    // keep self-test calls out of the metrics of the actual run
+    const bool probing = probe::enabled();
+    probe::enable(false);
+    self_test();
+    probe::enable(probing);
+#endif
+
+    const std::vector<std::string> args(argv + 1, argv + argc);
+
+    auto usage = []() -> int {
+        std::cerr << "usage: ip-filter [--build-index <file> | [--query <file> | --follow <file>]"
+                     " [--blocklist <file>] [--filter <expr>]...]" << std::endl;
+        return EXIT_FAILURE;
+    };
+
+    std::string    index_build  = {};
+    std::string    index_query  = {};
+    std::string    follow_path  = {};
+    std::string    block_path   = {};
+    stdinp_split_t filter_texts = {};
+
+    for (std::size_t it = 0; it < args.size(); it += 2)
+    {
+        if (it + 1 == args.size())
+        {
+            return usage();
+        }
+
+        const std::string& flag  = args.at(it);
+        const std::string& value = args.at(it + 1);
+
+        if (flag == "--build-index")
+        {
+            index_build = value;
+        }
+        else if (flag == "--query")
+        {
+            index_query = value;
+        }
+        else if (flag == "--follow")
+        {
+            follow_path = value;
+        }
+        else if (flag == "--blocklist")
+        {
+            block_path = value;
+        }
+        else if (flag == "--filter")
+        {
+            filter_texts.push_back(value);
+        }
+        else
+        {
+            return usage();
+        }
+    }
+
+    if (not index_build.empty())
+    {
+        if (not index_query.empty() or not follow_path.empty() or not block_path.empty() or not filter_texts.empty())
+        {
+            return usage();
+        }
+        if (not build_index(pack_mapper(parse_stdin()), index_build))
+        {
+            std::cerr << "failed to write index " << index_build << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    ip_cidr_set_t blocklist = {};
+
+    if (not block_path.empty())
+    {
+        std::string error = {};
+        if (not blocklist.load(block_path, error))
+        {
+            std::cerr << error << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    ip_filters_t ip_filters = {};
+
+    for (const auto& text: filter_texts)
+    {
+        ip_program_t program = {};
+        std::string  error   = {};
+
+        if (not compile_filter(text, program, error, block_path.empty() ? nullptr : &blocklist))
+        {
+            std::cerr << "bad filter \"" << text << "\": " << error << std::endl;
+            return EXIT_FAILURE;
+        }
+        ip_filters.push_back(std::move(program));
+    }
+
+    const bool tag_listed = not block_path.empty() and ip_filters.empty();
+
+    if (not follow_path.empty())
+    {
+        if (not index_query.empty() or tag_listed)
+        {
+            return usage();
+        }
+
+        const stdout_check_t checks = ip_filters.empty() ? builtin_checks() : stdout_check_t{};
+
+        std::signal(SIGINT,  stop_following);
+        std::signal(SIGTERM, stop_following);
+
+        if (not follow_file(follow_path, checks, ip_filters))
+        {
+            std::cerr << "failed to open " << follow_path << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    auto print_column = [&](const ip_column_t& ip_column) {
+        if (tag_listed)
+        {
+            print_listed(ip_column, blocklist);
+        }
+        for (const auto& program: ip_filters)
+        {
+            print_stdout(ip_column, program);
+        }
+    };
+
+    if (not index_query.empty())
+    {
+        const ip_index_t ip_index(index_query);
+        if (not ip_index.valid())
+        {
+            std::cerr << "failed to map index " << index_query << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (ip_filters.empty() and not tag_listed)
+        {
+            for (const auto& is_print: builtin_checks())
+            {
+                print_stdout(ip_index.column(), is_print);
+            }
+        }
+        print_column(ip_index.column());
+        return EXIT_SUCCESS;
+    }
+
+    const ip_mapper_t ip_mapper = parse_stdin();
+
+    if (ip_filters.empty() and not tag_listed)
+    {
+        for (const auto& is_print: builtin_checks())
+        {
+            print_stdout(ip_mapper, is_print);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    const ip_packed_t ip_packed = pack_mapper(ip_mapper);
+    print_column(ip_packed.column());
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
@@ -10,6 +11,7 @@
 #include <vector>
 
 #include <logger.hpp>
+#include <probe.hpp>
 
 // TODO: add tests
 // TODO: implement memory extension
@@ -84,6 +86,7 @@ public:
     // O(N)
     block::pointer allocate(const std::size_t num) {
         LOG("num = {}", num);
+        PROBE_SCOPE("mem.pool.block.allocate");
         assert((num == 1) and "block pool permits allocate one element at a time");
         const auto pblock = [this]() -> block::pointer {
             for (auto ptr = m_mem; ptr < (m_mem + block::amount); ++ptr) {
@@ -94,8 +97,10 @@ public:
             return nullptr;
         }();
         if (not pblock) {
+            PROBE_COUNT("mem.pool.block.exhausted", 1);
             throw std::bad_alloc{};
         }
+        PROBE_RECORD("mem.pool.block.allocate.scan", static_cast<std::uint64_t>(ptr_to_idx(pblock)));
         m_idx.at(ptr_to_idx(pblock)) = block::occupation::take;
         assert(pblock >= m_mem);
         return pblock;
@@ -107,6 +112,7 @@ public:
         assert((num == 1) and "block pool permits deallocate one element at a time");
         assert((m_mem <= ptr) and (ptr < (m_mem + block::amount)) and "this memory is not owned by block pool");
         assert(m_idx.at(ptr_to_idx(ptr)) == block::occupation::take);
+        PROBE_COUNT("mem.pool.block.deallocate", 1);
         m_idx.at(ptr_to_idx(ptr)) = block::occupation::free;
     }
 
@@ -1,10 +1,18 @@
+#include <array>
 #include <cassert>
+#include <deque>
 #include <iostream>
+#include <iterator>
 #include <list>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <utility>
 #include <vector>
 
+#include <parse-ip.hpp>
+#include <print-batch.hpp>
 #include <print-ip.hpp>
 
 int main()
@@ -29,6 +37,61 @@ int main()
     assert(g == "400.300.200.100");
     assert(h == "192.168.1.1");
 
+    using printer::print_ip_to;
+    using printer::format_ip_size;
+
+    static_assert(format_ip_size<int32_t>() == 15);
+    static_assert(format_ip_size<std::tuple<uint8_t, uint8_t>>() == 7);
+
+    std::array<char, format_ip_size<int64_t>()> buf = {};
+    const auto end = print_ip_to(buf.data(), int64_t{8875824491850138409});
+    assert(std::string_view(buf.data(), end - buf.data()) == d);
+
+    using printer::format_ip;
+    using printer::parse_ip;
+
+    static_assert(format_ip(int32_t{2130706433}) == "127.0.0.1");
+    static_assert(format_ip(std::make_tuple(192, 168, 1, 1)) == "192.168.1.1");
+    static_assert(format_ip(std::make_tuple(int16_t{-1}, 0)) == "-1.0");
+    static_assert(parse_ip<uint32_t>("127.0.0.1") == 2130706433U);
+    static_assert(parse_ip<int8_t>("255") == int8_t{-1});
+    static_assert(parse_ip<std::tuple<int, int>>("-7.300") == std::make_tuple(-7, 300));
+    static_assert(parse_ip<uint64_t>(format_ip(uint64_t{8875824491850138409}).view()) == 8875824491850138409U);
+
+    try {
+        [[maybe_unused]]
+        const auto bad = parse_ip<uint32_t>("127.0.0.256");
+        assert(false);
+    } catch (const std::out_of_range&) {
+    }
+
+    std::string out = {};
+    print_ip_to(std::back_inserter(out), std::make_tuple(10, 0, 0, 1));
+    assert(out == "10.0.0.1");
+
+    const uint8_t packet[] = {10, 0, 0, 254};
+    assert(print_ip(packet) == "10.0.0.254");
+    assert(print_ip(std::array<uint8_t, 4>{192, 168, 0, 1}) == "192.168.0.1");
+    assert(print_ip(std::deque<int>{1, 2, 3}) == "1.2.3");
+    assert(print_ip(std::make_pair(172, 16)) == "172.16");
+    static_assert(format_ip(std::make_pair(uint8_t{8}, uint8_t{8})) == "8.8");
+    assert(print_ip(true) == "1" and print_ip(false) == "0");
+    assert(print_ip(std::make_tuple(true, false)) == "1.0");
+    assert(print_ip(std::array<bool, 2>{true, false}) == "1.0");
+    static_assert(format_ip(true) == "1");
+
+    using printer::print_ip_batch;
+
+    const auto ips = std::vector<uint32_t>{2130706433U, 0U, UINT32_MAX};
+    assert(print_ip_batch(ips) == "127.0.0.1\n0.0.0.0\n255.255.255.255\n");
+    assert(print_ip_batch(ips, ",") == "127.0.0.1,0.0.0.0,255.255.255.255,");
+
+    auto many = std::vector<uint32_t>(100000);
+    for (std::size_t it{}; it < many.size(); ++it) {
+        many[it] = static_cast<uint32_t>(it * 2654435761U);
+    }
+    assert(print_ip_batch(many, "\n", 4) == print_ip_batch(many, "\n", 1));
+
     std::cout << a + '\n'
               << b + '\n'
               << c + '\n'
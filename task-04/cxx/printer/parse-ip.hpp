@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <type-helper.hpp>
+
+namespace printer {
+
+namespace detail {
+
+template<typename T>
+constexpr auto take_number(std::string_view& inp) -> T {
+    using U = std::make_unsigned_t<T>;
+
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>) {
+        if (not inp.empty() and inp.front() == '-') {
+            negative = true;
+            inp.remove_prefix(1);
+        }
+    }
+
+    if (inp.empty() or inp.front() < '0' or inp.front() > '9') {
+        throw std::invalid_argument{"ip octet is not a number"};
+    }
+
+    constexpr U limit = static_cast<U>(std::numeric_limits<T>::max());
+    const U bound = negative ? static_cast<U>(limit + 1) : limit;
+
+    U out = 0;
+    while (not inp.empty() and inp.front() >= '0' and inp.front() <= '9') {
+        const auto digit = static_cast<U>(inp.front() - '0');
+        if (out > (bound - digit) / 10) {
+            throw std::out_of_range{"ip octet does not fit into its type"};
+        }
+        out = static_cast<U>(out * 10 + digit);
+        inp.remove_prefix(1);
+    }
+
+    return negative ? static_cast<T>(U{} - out) : static_cast<T>(out);
+}
+
+constexpr void take_dot(std::string_view& inp) {
+    if (inp.empty() or inp.front() != '.') {
+        throw std::invalid_argument{"ip octets should be separated by dot"};
+    }
+    inp.remove_prefix(1);
+}
+
+template<typename T, std::size_t... I>
+constexpr auto take_tuple(std::string_view& inp, std::index_sequence<I...>) -> T {
+    T out = {};
+    ((I > 0 ? take_dot(inp) : void(), std::get<I>(out) = take_number<std::tuple_element_t<I, T>>(inp)), ...);
+    return out;
+}
+
+}
+
+/**
+ * @brief Parse IP into integer-like output, one dotted octet per byte
+ *
+ * @param[in] ip Dotted text, e.g. "127.0.0.1" for 32-bit output
+ * @return T
+ */
+template<typename T,
+         typename std::enable_if_t<std::is_integral_v<T>, bool> = true>
+constexpr auto parse_ip(std::string_view ip) -> T {
+    using U = std::make_unsigned_t<T>;
+
+    U out = 0;
+    for (std::size_t it{}; it < sizeof(T); ++it) {
+        if (it > 0) {
+            detail::take_dot(ip);
+        }
+        const auto octet = detail::take_number<unsigned char>(ip);
+        out = static_cast<U>((out << 8) | octet);
+    }
+
+    if (not ip.empty()) {
+        throw std::invalid_argument{"ip has trailing symbols"};
+    }
+
+    return static_cast<T>(out);
+}
+
+/**
+ * @brief Parse IP into tuple-like output, one dotted number per element
+ *
+ * @param[in] ip Dotted text, e.g. "192.168.1.1" for 4-element tuple
+ * @return T
+ */
+template<typename T,
+         typename std::enable_if_t<is_tuple_v<T>, bool> = true>
+constexpr auto parse_ip(std::string_view ip) -> T {
+    auto out = detail::take_tuple<T>(ip, std::make_index_sequence<std::tuple_size_v<T>>{});
+
+    if (not ip.empty()) {
+        throw std::invalid_argument{"ip has trailing symbols"};
+    }
+
+    return out;
+}
+
+}
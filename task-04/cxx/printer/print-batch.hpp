@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <print-ip.hpp>
+
+namespace printer {
+
+/**
+ * @brief Maximum length of batch printed from integer-like input
+ *
+ * @param[in] num Number of addresses
+ * @param[in] term Terminator written after every address
+ * @return std::size_t
+ */
+template<typename T,
+         typename std::enable_if_t<std::is_integral_v<T>, bool> = true>
+constexpr auto format_ip_batch_size(const std::size_t num, const std::string_view term) -> std::size_t {
+    return num * (format_ip_size<T>() + term.size());
+}
+
+/**
+ * @brief Print contiguous range of integer-like IPs into caller-provided buffer
+ *
+ * @param[out] buf Buffer of at least format_ip_batch_size<T>(last - first, term) chars
+ * @param[in] first Pointer to the first address
+ * @param[in] last Pointer past the last address
+ * @param[in] term Terminator written after every address
+ * @return char* Pointer past the last written char
+ */
+template<typename T,
+         typename std::enable_if_t<std::is_integral_v<T>, bool> = true>
+auto print_ip_batch_to(char* buf, const T* first, const T* const last, const std::string_view term = "\n") -> char* {
+    for (; first != last; ++first) {
+        buf = print_ip_to(buf, *first);
+        buf = std::copy(term.cbegin(), term.cend(), buf);
+    }
+    return buf;
+}
+
+/**
+ * @brief Print contiguous range of integer-like IPs, optionally splitting work across threads
+ *
+ * @param[in] first Pointer to the first address
+ * @param[in] last Pointer past the last address
+ * @param[in] term Terminator written after every address
+ * @param[in] threads Number of workers, 0 picks hardware concurrency
+ * @return std::string Addresses in input order
+ */
+template<typename T,
+         typename std::enable_if_t<std::is_integral_v<T>, bool> = true>
+auto print_ip_batch(const T* const first, const T* const last, const std::string_view term = "\n",
+                    std::size_t threads = 1) -> std::string {
+    constexpr std::size_t MIN_CHUNK = 1 << 14;
+
+    const auto num = static_cast<std::size_t>(last - first);
+
+    if (threads == 0) {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    threads = std::max<std::size_t>(1, std::min(threads, num / MIN_CHUNK));
+
+    if (threads == 1) {
+        std::string out(format_ip_batch_size<T>(num, term), '\x00');
+        out.resize(print_ip_batch_to(out.data(), first, last, term) - out.data());
+        return out;
+    }
+
+    std::vector<std::string> parts(threads);
+    std::vector<std::thread> workers = {};
+
+    for (std::size_t it{}; it < threads; ++it) {
+        const auto beg = first + (num * it) / threads;
+        const auto end = first + (num * (it+1)) / threads;
+        workers.emplace_back([&part = parts[it], beg, end, term]() {
+            part.resize(format_ip_batch_size<T>(static_cast<std::size_t>(end - beg), term));
+            part.resize(print_ip_batch_to(part.data(), beg, end, term) - part.data());
+        });
+    }
+
+    std::size_t len = 0;
+    for (std::size_t it{}; it < threads; ++it) {
+        workers[it].join();
+        len += parts[it].size();
+    }
+
+    std::string out = {};
+    out.reserve(len);
+    for (const auto& part: parts) {
+        out += part;
+    }
+    return out;
+}
+
+/**
+ * @brief Print contiguous container of integer-like IPs
+ *
+ * @param[in] ips Container exposing data() and size()
+ * @param[in] term Terminator written after every address
+ * @param[in] threads Number of workers, 0 picks hardware concurrency
+ * @return std::string Addresses in input order
+ */
+template<typename C,
+         typename std::enable_if_t<std::is_integral_v<std::remove_pointer_t<decltype(std::data(std::declval<const C&>()))>>, bool> = true>
+auto print_ip_batch(const C& ips, const std::string_view term = "\n", const std::size_t threads = 1) -> std::string {
+    return print_ip_batch(std::data(ips), std::data(ips) + std::size(ips), term, threads);
+}
+
+}
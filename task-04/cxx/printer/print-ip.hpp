@@ -1,41 +1,277 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
 #include <string>
 #include <string_view>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 
 #include <type-helper.hpp>
 
 namespace printer {
 
+namespace detail {
+
+struct octet_text {
+    std::uint8_t len;
+    std::array<char, 3> txt;
+};
+
+inline constexpr auto OCTET_TEXT = []() {
+    std::array<octet_text, 256> table = {};
+    for (std::size_t it{}; it < table.size(); ++it) {
+        auto& [len, txt] = table[it];
+        if (it >= 100) {
+            txt = {char('0' + it / 100), char('0' + it / 10 % 10), char('0' + it % 10)};
+            len = 3;
+        } else if (it >= 10) {
+            txt = {char('0' + it / 10), char('0' + it % 10), '\x00'};
+            len = 2;
+        } else {
+            txt = {char('0' + it), '\x00', '\x00'};
+            len = 1;
+        }
+    }
+    return table;
+}();
+
+// std::make_unsigned rejects bool, which prints as a single 0 or 1
+template<typename T>
+struct unsigned_of {
+    using type = std::make_unsigned_t<T>;
+};
+
+template<>
+struct unsigned_of<bool> {
+    using type = std::uint8_t;
+};
+
+template<typename T>
+using unsigned_of_t = typename unsigned_of<T>::type;
+
+template<typename T>
+constexpr std::size_t max_digits() {
+    return std::numeric_limits<T>::digits10 + 1 + (std::is_signed_v<T> ? 1 : 0);
+}
+
+template<typename OutputIt>
+constexpr OutputIt put_octet(OutputIt out, const std::uint8_t octet) {
+    const auto& [len, txt] = OCTET_TEXT[octet];
+    for (std::uint8_t it{}; it < len; ++it) {
+        *out++ = txt[it];
+    }
+    return out;
+}
+
+template<typename OutputIt, typename T>
+constexpr OutputIt put_number(OutputIt out, const T& val) {
+    using U = unsigned_of_t<T>;
+
+    U inp = static_cast<U>(val);
+    if constexpr (std::is_signed_v<T>) {
+        if (val < 0) {
+            *out++ = '-';
+            inp = static_cast<U>(U{} - inp);
+        }
+    }
+
+    std::array<char, max_digits<T>()> buf = {};
+    std::size_t len = 0;
+    do {
+        buf[len++] = static_cast<char>('0' + inp % 10);
+        inp = static_cast<U>(inp / 10);
+    } while (inp);
+
+    while (len) {
+        *out++ = buf[--len];
+    }
+    return out;
+}
+
+}
+
 /**
- * @brief Print IP from integer-like input
+ * @brief Maximum length of IP printed from integer-like input
+ *
+ * @return std::size_t
+ */
+template<typename T,
+         typename std::enable_if_t<std::is_integral_v<T>, bool> = true>
+constexpr auto format_ip_size() -> std::size_t {
+    return sizeof(T) * 4 - 1;
+}
+
+/**
+ * @brief Maximum length of IP printed from tuple-like input
+ *
+ * @return std::size_t
+ */
+template<typename T,
+         typename std::enable_if_t<is_tuple_v<T>, bool> = true>
+constexpr auto format_ip_size() -> std::size_t {
+    return std::apply([](auto... octet) {
+        return (detail::max_digits<decltype(octet)>() + ... + 0) + sizeof...(octet) - 1;
+    }, T{});
+}
+
+/**
+ * @brief Maximum length of IP printed from container-like input
  *
  * @param[in] ip Value to be printed
- * @return std::string
+ * @return std::size_t
  */
 template<typename T,
+         typename std::enable_if_t<is_container_v<T>, bool> = true>
+auto format_ip_size(const T& ip) -> std::size_t {
+    const auto num = static_cast<std::size_t>(std::distance(std::begin(ip), std::end(ip)));
+    return num ? (num * (detail::max_digits<container_value_t<T>>() + 1) - 1) : 0;
+}
+
+/**
+ * @brief Print IP from integer-like input into caller-provided output
+ *
+ * @param[out] out Output iterator, at least format_ip_size<T>() chars are written
+ * @param[in] ip Value to be printed
+ * @return OutputIt Iterator past the last written char
+ */
+template<typename OutputIt, typename T,
          typename std::enable_if_t<std::is_integral_v<T>, bool> = true>
-auto print_ip(const T& ip) -> std::string {
+constexpr auto print_ip_to(OutputIt out, const T& ip) -> OutputIt {
     constexpr auto N = sizeof(T);
     using I = decltype(sizeof(T));
 
-    uint64_t    inp = ip;
-    std::string out = {};
+    const auto inp = static_cast<detail::unsigned_of_t<T>>(ip);
 
-    for (I it{}; it < N; ++it) {
-        if (it > 0) {
-            out = std::to_string(inp & 0xFF) + '.' + out;
-        } else {
-            out = std::to_string(inp & 0xFF);
+    for (I it{N}; it > 0; --it) {
+        out = detail::put_octet(out, static_cast<std::uint8_t>((inp >> ((it-1) * 8)) & 0xFF));
+        if (it > 1) {
+            *out++ = '.';
         }
-        inp = (inp >> 8);
     }
 
     return out;
 }
 
+/**
+ * @brief Print IP from container-like input into caller-provided output
+ *
+ * @param[out] out Output iterator, at most format_ip_size(ip) chars are written
+ * @param[in] ip Value to be printed
+ * @return OutputIt Iterator past the last written char
+ */
+template<typename OutputIt, typename T,
+         typename std::enable_if_t<is_container_v<T>, bool> = true>
+constexpr auto print_ip_to(OutputIt out, const T& ip) -> OutputIt {
+    if constexpr (is_contiguous_bytes_v<T>) {
+        const auto* const ptr = std::data(ip);
+        const auto        num = std::size(ip);
+        for (std::size_t it{}; it < num; ++it) {
+            if (it > 0) {
+                *out++ = '.';
+            }
+            out = detail::put_octet(out, ptr[it]);
+        }
+    } else {
+        bool first = true;
+        for (const auto& octet: ip) {
+            if (not first) {
+                *out++ = '.';
+            }
+            out = detail::put_number(out, octet);
+            first = false;
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Print IP from tuple-like input into caller-provided output
+ *
+ * @param[out] out Output iterator, at most format_ip_size<T>() chars are written
+ * @param[in] ip Value to be printed
+ * @return OutputIt Iterator past the last written char
+ */
+template<typename OutputIt, typename T, size_t I = 0,
+         typename std::enable_if_t<is_tuple_v<T>, bool> = true>
+constexpr auto print_ip_to(OutputIt out, const T& ip) -> OutputIt {
+    out = detail::put_number(out, std::get<I>(ip));
+    if constexpr ((I+1) < std::tuple_size_v<T>) {
+        *out++ = '.';
+        out = print_ip_to<OutputIt, T, (I+1)>(out, ip);
+    }
+    return out;
+}
+
+/**
+ * @brief Print IP from string-like input into caller-provided output
+ *
+ * @param[out] out Output iterator, exactly ip.size() chars are written
+ * @param[in] ip Value to be printed
+ * @return OutputIt Iterator past the last written char
+ */
+template<typename OutputIt>
+constexpr auto print_ip_to(OutputIt out, const std::string_view ip) -> OutputIt {
+    for (const auto symb: ip) {
+        *out++ = symb;
+    }
+    return out;
+}
+
+/**
+ * @brief Fixed-capacity string holding a formatted IP
+ */
+template<std::size_t N>
+struct ip_string {
+    std::array<char, N> buf = {};
+    std::size_t len = {};
+
+    constexpr auto view() const -> std::string_view {
+        return std::string_view{buf.data(), len};
+    }
+
+    constexpr bool operator==(const std::string_view rhs) const {
+        return view() == rhs;
+    }
+
+    constexpr bool operator!=(const std::string_view rhs) const {
+        return view() != rhs;
+    }
+};
+
+/**
+ * @brief Format IP from integer-like or tuple-like input at compile time
+ *
+ * @param[in] ip Value to be printed
+ * @return ip_string<format_ip_size<T>()>
+ */
+template<typename T,
+         typename std::enable_if_t<std::is_integral_v<T> or is_tuple_v<T>, bool> = true>
+constexpr auto format_ip(const T& ip) -> ip_string<format_ip_size<T>()> {
+    ip_string<format_ip_size<T>()> out = {};
+    auto* const end = print_ip_to(out.buf.data(), ip);
+    out.len = static_cast<std::size_t>(end - out.buf.data());
+    return out;
+}
+
+/**
+ * @brief Print IP from integer-like input
+ *
+ * @param[in] ip Value to be printed
+ * @return std::string
+ */
+template<typename T,
+         typename std::enable_if_t<std::is_integral_v<T>, bool> = true>
+auto print_ip(const T& ip) -> std::string {
+    std::string out(format_ip_size<T>(), '\x00');
+    out.resize(print_ip_to(out.data(), ip) - out.data());
+    return out;
+}
+
 /**
  * @brief Print IP from container-like input
  *
@@ -45,11 +281,8 @@ auto print_ip(const T& ip) -> std::string {
 template<typename T,
          typename std::enable_if_t<is_container_v<T>, bool> = true>
 auto print_ip(const T& ip) -> std::string {
-    std::string out = {};
-    for (const auto& octet: ip) {
-        out = out + std::to_string(octet) + '.';
-    }
-    out.pop_back();
+    std::string out(format_ip_size(ip), '\x00');
+    out.resize(print_ip_to(out.data(), ip) - out.data());
     return out;
 }
 
@@ -59,13 +292,11 @@ auto print_ip(const T& ip) -> std::string {
  * @param[in] ip Value to be printed
  * @return std::string
  */
-template<typename T, size_t I = 0,
+template<typename T,
          typename std::enable_if_t<is_tuple_v<T>, bool> = true>
 auto print_ip(const T& ip) -> std::string {
-    auto out = std::to_string(std::get<I>(ip));
-    if constexpr ((I+1) < std::tuple_size_v<T>) {
-        out += '.' + print_ip<T, (I+1)>(ip);
-    }
+    std::string out(format_ip_size<T>(), '\x00');
+    out.resize(print_ip_to(out.data(), ip) - out.data());
     return out;
 }
 
@@ -75,7 +306,7 @@ auto print_ip(const T& ip) -> std::string {
  * @param[in] ip Value to be printed
  * @return std::string
  */
-auto print_ip(const std::string_view ip) -> std::string {
+inline auto print_ip(const std::string_view ip) -> std::string {
     return std::string{ip};
 }
 
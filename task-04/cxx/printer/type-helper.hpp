@@ -1,25 +1,33 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <iterator>
 #include <list>
+#include <string>
+#include <string_view>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace printer {
 
 template<typename T>
+using container_value_t = std::remove_cv_t<std::remove_reference_t<
+    decltype(*std::begin(std::declval<const T&>()))>>;
+
+template<typename T, typename = void>
 struct is_container {
     static constexpr bool value = false;
 };
 
 template<typename T>
-struct is_container<std::list<T>> {
-    static constexpr bool value = std::is_integral_v<T>;
-};
-
-template<typename T>
-struct is_container<std::vector<T>> {
-    static constexpr bool value = std::is_integral_v<T>;
+struct is_container<T, std::void_t<decltype(std::begin(std::declval<const T&>())),
+                                   decltype(std::end  (std::declval<const T&>()))>> {
+    static constexpr bool value = std::is_integral_v<container_value_t<T>> and
+                                  not std::is_convertible_v<const T&, std::string_view>;
 };
 
 template<typename T>
@@ -29,29 +37,66 @@ static_assert(not is_container_v<int>);
 static_assert(not is_container_v<std::list  <double>>);
 static_assert(not is_container_v<std::vector<double>>);
 static_assert(not is_container_v<std::tuple <int>>);
+static_assert(not is_container_v<std::string>);
 
 static_assert(is_container_v<std::list  <int>>);
 static_assert(is_container_v<std::vector<int>>);
+static_assert(is_container_v<std::deque <int>>);
+static_assert(is_container_v<std::array <uint8_t, 4>>);
+static_assert(is_container_v<uint8_t[4]>);
+
+template<typename T, typename = void>
+struct is_contiguous_bytes {
+    static constexpr bool value = false;
+};
+
+template<typename T>
+struct is_contiguous_bytes<T, std::void_t<decltype(std::data(std::declval<const T&>())),
+                                          decltype(std::size(std::declval<const T&>()))>> {
+    static constexpr bool value = is_container_v<T> and std::is_same_v<
+        std::remove_cv_t<std::remove_pointer_t<decltype(std::data(std::declval<const T&>()))>>, uint8_t>;
+};
 
-template<typename... Tp>
+template<typename T>
+inline constexpr bool is_contiguous_bytes_v = is_contiguous_bytes<T>::value;
+
+static_assert(not is_contiguous_bytes_v<std::list  <uint8_t>>);
+static_assert(not is_contiguous_bytes_v<std::vector<int>>);
+
+static_assert(is_contiguous_bytes_v<std::vector<uint8_t>>);
+static_assert(is_contiguous_bytes_v<std::array <uint8_t, 4>>);
+static_assert(is_contiguous_bytes_v<uint8_t[16]>);
+
+template<typename T, typename I>
+struct is_integral_tuple;
+
+template<typename T, std::size_t... I>
+struct is_integral_tuple<T, std::index_sequence<I...>> {
+    static constexpr bool value = std::conjunction_v<std::is_integral<std::tuple_element_t<I, T>>...>;
+};
+
+template<typename T, typename = void>
 struct is_tuple {
     static constexpr bool value = false;
 };
 
-template<typename... Tp>
-struct is_tuple<std::tuple<Tp...>> {
-    static constexpr bool value = std::conjunction_v<std::is_integral<Tp>...>;
+template<typename T>
+struct is_tuple<T, std::void_t<decltype(std::tuple_size<T>::value)>> {
+    static constexpr bool value = not is_container_v<T> and
+        is_integral_tuple<T, std::make_index_sequence<std::tuple_size_v<T>>>::value;
 };
 
-template<typename... Tp>
-inline constexpr bool is_tuple_v = is_tuple<Tp...>::value;
+template<typename T>
+inline constexpr bool is_tuple_v = is_tuple<T>::value;
 
 static_assert(not is_tuple_v<int>);
 static_assert(not is_tuple_v<std::list  <int>>);
 static_assert(not is_tuple_v<std::vector<int>>);
 static_assert(not is_tuple_v<std::tuple <int, double>>);
+static_assert(not is_tuple_v<std::array <uint8_t, 4>>);
 
 static_assert(is_tuple_v<std::tuple<int, int>>);
 static_assert(is_tuple_v<std::tuple<int, uint16_t>>);
+static_assert(is_tuple_v<std::pair <int, uint8_t>>);
 
 }
@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <random>
+#include <vector>
+
+#include <unistd.h>
+
+#include <tensor.hpp>
+
+namespace {
+
+using TYPE = std::int64_t;
+
+constexpr TYPE DFLT = 0;
+
+volatile TYPE g_sink = {};
+
+class CountingResource final: public std::pmr::memory_resource
+{
+
+public:
+
+    std::size_t bytes() const noexcept
+    {
+        return m_bytes;
+    }
+
+private:
+
+    void* do_allocate(const std::size_t bytes, const std::size_t align) override
+    {
+        m_bytes += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+
+    void do_deallocate(void* const ptr, const std::size_t bytes, const std::size_t align) override
+    {
+        m_bytes -= bytes;
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, align);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& rhs) const noexcept override
+    {
+        return this == &rhs;
+    }
+
+    std::size_t m_bytes = {};
+
+};
+
+// Current (not peak) resident set size, so successive cases can be told apart.
+long rss_kb()
+{
+    long pages = 0;
+    long resident = 0;
+
+    auto statm = std::ifstream{"/proc/self/statm"};
+    statm >> pages >> resident;
+
+    return resident * (::sysconf(_SC_PAGESIZE) / 1024);
+}
+
+// Keeps `val` and everything reachable through memory observable, so loop-invariant calls are not hoisted.
+template<typename V>
+void do_not_optimize(const V& val)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(val) : "memory");
+#else
+    g_sink = static_cast<TYPE>(val);
+#endif
+}
+
+template<typename Fn>
+double measure_ns(const std::size_t ops, Fn&& fn)
+{
+    const auto beg = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - beg).count() / static_cast<double>(ops ? ops : 1);
+}
+
+void report(const std::size_t rank, const double cells, const double density, const std::size_t nnz,
+            const char* const op, const double ns, const double bytes_per_elem, const long rss_delta_kb)
+{
+    std::cout << std::setw(4)  << rank
+              << std::setw(10) << std::scientific << std::setprecision(0) << cells
+              << std::setw(10) << density
+              << std::setw(12) << nnz
+              << std::setw(14) << op
+              << std::setw(12) << std::fixed << std::setprecision(1) << ns
+              << std::setw(12) << bytes_per_elem
+              << std::setw(14) << rss_delta_kb
+              << '\n';
+}
+
+template<std::size_t Rank>
+void run(const double cells, const double density)
+{
+    using Tensor = tensor::Tensor<TYPE, DFLT, Rank>;
+    using Coord  = typename Tensor::Coord;
+
+    const auto side = static_cast<std::size_t>(std::llround(std::pow(cells, 1.0 / Rank)));
+    const auto want = static_cast<std::size_t>(cells * density);
+
+    if ((side == 0) or (want == 0))
+    {
+        return;
+    }
+
+    auto rng  = std::mt19937_64{Rank};
+    auto dist = std::uniform_int_distribution<std::size_t>{0, (side - 1)};
+
+    auto random_coords = [&rng, &dist](const std::size_t num)
+    {
+        auto out = std::vector<Coord>(num);
+        for (auto& coord: out)
+        {
+            for (auto& idx: coord)
+            {
+                idx = dist(rng);
+            }
+        }
+        return out;
+    };
+
+    const auto hits = random_coords(want);
+    auto probes = random_coords(want);
+
+    auto counter = CountingResource{};
+    auto tensor  = Tensor{&counter};
+
+    const auto rss_base = rss_kb();
+
+    const auto insert_ns = measure_ns(hits.size(), [&]()
+    {
+        for (std::size_t it{0}; it < hits.size(); ++it)
+        {
+            tensor.set(hits[it], static_cast<TYPE>(it + 1));
+        }
+    });
+
+    const auto rss = rss_kb() - rss_base;
+    const auto nnz = tensor.size();
+    const auto bpe = static_cast<double>(counter.bytes()) / static_cast<double>(nnz);
+
+    probes.erase(std::remove_if(probes.begin(), probes.end(), [&tensor](const Coord& coord)
+    {
+        return tensor.get(coord) != DFLT;
+    }), probes.end());
+
+    const auto hit_ns = measure_ns(hits.size(), [&]()
+    {
+        TYPE acc = {};
+        for (const auto& coord: hits)
+        {
+            acc += tensor.get(coord);
+        }
+        g_sink = acc;
+    });
+
+    const auto miss_ns = measure_ns(probes.size(), [&]()
+    {
+        TYPE acc = {};
+        for (const auto& coord: probes)
+        {
+            acc += tensor.get(coord);
+        }
+        g_sink = acc;
+    });
+
+    constexpr std::size_t SIZE_CALLS = 1'000'000;
+    const auto size_ns = measure_ns(SIZE_CALLS, [&]()
+    {
+        for (std::size_t it{0}; it < SIZE_CALLS; ++it)
+        {
+            do_not_optimize(tensor.size());
+        }
+    });
+
+    const auto iter_ns = measure_ns(nnz, [&]()
+    {
+        TYPE acc = {};
+        tensor.for_each([&acc](const Coord&, const TYPE val)
+        {
+            acc += val;
+        });
+        g_sink = acc;
+    });
+
+    const auto erase_ns = measure_ns(hits.size(), [&]()
+    {
+        for (const auto& coord: hits)
+        {
+            tensor.set(coord, DFLT);
+        }
+    });
+
+    report(Rank, cells, density, nnz, "insert",   insert_ns, bpe, rss);
+    report(Rank, cells, density, nnz, "lookup-hit",  hit_ns, bpe, rss);
+    report(Rank, cells, density, nnz, "lookup-miss", miss_ns, bpe, rss);
+    report(Rank, cells, density, nnz, "erase",    erase_ns, bpe, rss);
+    report(Rank, cells, density, nnz, "size",     size_ns,  bpe, rss);
+    report(Rank, cells, density, nnz, "iterate",  iter_ns,  bpe, rss);
+}
+
+}
+
+// Usage: tensor-bench [max-cells-exponent (3..8, default 6)] [max-stored-elements (default 1e7)]
+int main(const int argc, const char* const argv[])
+{
+    const int    max_exp = (argc > 1) ? std::atoi(argv[1]) : 6;
+    const double max_nnz = (argc > 2) ? std::atof(argv[2]) : 1e7;
+
+    std::cout << std::setw(4)  << "rank"
+              << std::setw(10) << "cells"
+              << std::setw(10) << "density"
+              << std::setw(12) << "nnz"
+              << std::setw(14) << "op"
+              << std::setw(12) << "ns/op"
+              << std::setw(12) << "bytes/elem"
+              << std::setw(14) << "rss-delta-kb"
+              << '\n';
+
+    for (int exp{3}; exp <= std::min(max_exp, 8); ++exp)
+    {
+        const auto cells = std::pow(10.0, exp);
+
+        for (int dns{-6}; dns <= -1; ++dns)
+        {
+            const auto density = std::pow(10.0, dns);
+
+            if ((cells * density) < 1.0 or (cells * density) > max_nnz)
+            {
+                continue;
+            }
+
+            run<1>(cells, density);
+            run<2>(cells, density);
+            run<3>(cells, density);
+            run<4>(cells, density);
+            run<5>(cells, density);
+        }
+    }
+}
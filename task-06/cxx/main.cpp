@@ -1,8 +1,63 @@
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <memory_resource>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
+#include <block.hpp>
+#include <concurrent.hpp>
+#include <expr.hpp>
+#include <snapshot.hpp>
+#include <sparse.hpp>
 #include <tensor.hpp>
+#include <view.hpp>
+
+#include <probe.hpp>
+
+namespace {
+
+// Counts allocations passed on to the default resource, to tell which upstream a tensor draws from.
+class CountingResource final: public std::pmr::memory_resource
+{
+
+public:
+
+    std::size_t allocations() const noexcept
+    {
+        return m_allocations;
+    }
+
+private:
+
+    void* do_allocate(const std::size_t bytes, const std::size_t align) override
+    {
+        m_allocations += 1;
+        return std::pmr::get_default_resource()->allocate(bytes, align);
+    }
+
+    void do_deallocate(void* const ptr, const std::size_t bytes, const std::size_t align) override
+    {
+        std::pmr::get_default_resource()->deallocate(ptr, bytes, align);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& rhs) const noexcept override
+    {
+        return this == &rhs;
+    }
+
+    std::size_t m_allocations = {};
+
+};
+
+}
 
 int main()
 {
@@ -111,4 +166,278 @@ int main()
     }
 
     assert(matrix.size() == (SIZE+SIZE));
+
+    for (auto i{0}; i <= SIZE; ++i)
+    {
+        assert(matrix.at(i, i) == i and matrix.at(i, SIZE-i) == (SIZE-i));
+    }
+
+    auto fast = tensor::Tensor<TYPE, DFLT, 3>{};
+    fast(1, 2, 3) = 42;
+    assert(fast.size() == 1 and fast.at(1, 2, 3) == 42 and fast[1][2][3] == 42);
+    fast[1][2][3] = DFLT;
+    assert(fast.size() == 0 and fast(1, 2, 3) == DFLT);
+
+    auto buffer = std::array<std::byte, 4096>{};
+    auto upstream = std::pmr::monotonic_buffer_resource{buffer.data(), buffer.size()};
+    auto pooled = tensor::Tensor<TYPE, DFLT, RANK>{&upstream};
+    pooled(1, 1) = 1;
+    pooled[2][2] = 2;
+    auto copied = pooled;
+    pooled(1, 1) = DFLT;
+    assert(pooled.size() == 1 and copied.size() == 2 and copied.at(1, 1) == 1);
+
+    auto stable = tensor::Tensor<TYPE, DFLT, RANK>{};
+    auto& row_0 = stable[0];
+    for (auto i{1}; i <= 16; ++i)
+    {
+        stable[i][0] = i;
+    }
+    row_0[5] = 7;
+    assert(stable.at(0, 5) == 7 and stable.size() == 17 and row_0.size() == 1 and stable[16].size() == 1);
+
+    auto bounded_buffer = std::vector<std::byte>(1 << 20);
+    auto bounded = std::pmr::monotonic_buffer_resource{bounded_buffer.data(), bounded_buffer.size(),
+                                                       std::pmr::null_memory_resource()};
+    auto empty = tensor::Tensor<TYPE, DFLT, RANK>{&bounded};
+    auto empty_sum = TYPE{};
+    for (auto pass{0}; pass < 100; ++pass)
+    {
+        for (auto i{0}; i < 32; ++i)
+        {
+            for (auto k{0}; k < 32; ++k)
+            {
+                empty_sum += empty[i][k];
+            }
+        }
+    }
+    assert(empty_sum == DFLT and empty.size() == 0 and empty[3].size() == 0);
+
+    auto moved = std::move(copied);
+    assert(moved.size() == 2 and copied.size() == 0 and copied.at(1, 1) == DFLT);
+    copied(3, 3) = 3;
+    copied[4][4] = 4;
+    assert(copied.size() == 2 and copied.at(3, 3) == 3);
+    moved = std::move(copied);
+    assert(moved.size() == 2 and copied.size() == 0 and moved.at(4, 4) == 4);
+    copied = moved;
+    assert(copied.size() == 2);
+    auto counting = CountingResource{};
+    const auto counted = tensor::Tensor<TYPE, DFLT, RANK>{&counting};
+    copied = counted;
+    moved = std::move(copied);
+    const auto before = counting.allocations();
+    copied(2, 2) = 2;
+    assert(copied.size() == 1 and moved.size() == 0 and counting.allocations() > before);
+
+    auto shared = tensor::ConcurrentTensor<TYPE, DFLT, RANK>{};
+    auto writers = std::vector<std::thread>{};
+    for (auto t{0}; t < 4; ++t)
+    {
+        writers.emplace_back([&shared, t]()
+        {
+            for (auto i{0}; i < 100; ++i)
+            {
+                shared.add({static_cast<std::size_t>(i), 0}, 1);
+                shared.set({static_cast<std::size_t>(i), static_cast<std::size_t>(t + 1)}, t + 1);
+            }
+        });
+    }
+    for (auto& writer: writers)
+    {
+        writer.join();
+    }
+    assert(shared.size() == 500 and shared.at(7, 0) == 4 and shared.at(7, 3) == 3);
+    shared.add({7, 0}, -4);
+    assert(shared.size() == 499 and shared.freeze().size() == 499);
+
+    const auto path = (std::filesystem::temp_directory_path() / "tensor.snapshot").string();
+    tensor::save(matrix, path);
+    {
+        const auto frozen = tensor::Snapshot<TYPE, DFLT, RANK>{path};
+        assert(frozen.size() == matrix.size() and frozen.at(3, 3) == 3 and frozen.at(3, 4) == DFLT);
+        frozen.for_each([&matrix](const auto& coord, const TYPE val)
+        {
+            assert(matrix.get(coord) == val);
+        });
+        try
+        {
+            [[maybe_unused]]
+            const auto mismatch = tensor::Snapshot<TYPE, DFLT, 3>{path};
+            assert(false);
+        }
+        catch (const tensor::Exception::BadSnapshot& ex)
+        {
+            assert(std::strlen(ex.what()) > 0);
+        }
+    }
+    const auto corrupt = [&path, &matrix](const std::size_t offset, const std::uint64_t field)
+    {
+        tensor::save(matrix, path);
+        auto file = std::fstream{path, std::ios::binary | std::ios::in | std::ios::out};
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(reinterpret_cast<const char*>(&field), sizeof(field));
+        file.close();
+        try
+        {
+            [[maybe_unused]]
+            const auto rejected = tensor::Snapshot<TYPE, DFLT, RANK>{path};
+            assert(false);
+        }
+        catch (const tensor::Exception::BadSnapshot&)
+        {
+        }
+    };
+    corrupt(offsetof(tensor::SnapshotHeader, order), 0x0807060504030201ULL);
+    corrupt(offsetof(tensor::SnapshotHeader, val_bytes), sizeof(TYPE) * 2);
+    corrupt(offsetof(tensor::SnapshotHeader, nnz), (std::uint64_t{1} << 63) + matrix.size());
+    std::filesystem::remove(path);
+
+    auto lhs = tensor::Tensor<TYPE, DFLT, RANK>{};
+    auto rhs = tensor::Tensor<TYPE, DFLT, RANK>{};
+    lhs(0, 0) = 1;
+    lhs(1, 1) = 2;
+    rhs(1, 1) = 3;
+    rhs(2, 2) = -1;
+    tensor::Tensor<TYPE, DFLT, RANK> res = lhs + rhs * 2;
+    assert(res.size() == 3 and res.at(0, 0) == 1 and res.at(1, 1) == 8 and res.at(2, 2) == -2);
+    res = res - lhs;
+    assert(res.size() == 2 and res.at(0, 0) == DFLT and res.at(1, 1) == 6);
+    assert(tensor::nnz(lhs * rhs) == 1 and tensor::sum(tensor::hadamard(lhs, rhs)) == 6);
+    assert(tensor::max(lhs + rhs) == 5 and tensor::min(lhs + rhs) == -1 and tensor::sum(matrix) == SIZE * (SIZE+1));
+    try
+    {
+        res = lhs + 1;
+        assert(false);
+    }
+    catch (const tensor::Exception::DefaultMismatch& ex)
+    {
+        assert(std::strlen(ex.what()) > 0);
+    }
+
+    auto tiled = tensor::BlockTensor<TYPE, DFLT, RANK>{};
+    for (auto i{0}; i < 16; ++i)
+    {
+        for (auto k{0}; k < 16; ++k)
+        {
+            tiled.set({static_cast<std::size_t>(i), static_cast<std::size_t>(k)}, i * 16 + k + 1);
+        }
+    }
+    tiled.set({1000, 1000}, 7);
+    assert(tiled.size() == 257 and tiled.blocks() == 5 and tiled.at(9, 10) == 9 * 16 + 11 and tiled.at(999, 1000) == DFLT);
+    tiled.set({1000, 1000}, DFLT);
+    assert(tiled.size() == 256 and tiled.blocks() == 4 and tensor::sum(tiled) == 256 * 257 / 2);
+    tiled.for_each([&tiled](const auto& coord, const TYPE val)
+    {
+        assert(tiled.get(coord) == val and val == static_cast<TYPE>(coord[0] * 16 + coord[1] + 1));
+    });
+
+    auto row_3 = tensor::row(matrix, 3);
+    auto col_3 = tensor::column(matrix, 3);
+    assert(row_3.size() == 2 and row_3.at(3) == 3 and row_3.at(6) == 6 and col_3.at(6) == 3);
+    row_3.set({5}, 1);
+    assert(matrix.at(3, 5) == 1 and col_3.size() == 2 and tensor::sum(row_3) == 10);
+    row_3.set({5}, DFLT);
+    const auto& frozen_matrix = matrix;
+    const auto window = tensor::slice(frozen_matrix, {tensor::Range{2, 8, 2}, tensor::Range{2, 8, 2}});
+    assert(window.size() == 3 and window.at(1, 1) == 4 and window.at(0, 0) == 2);
+    assert(window.volume() == 9 and row_3.volume() > matrix.size());
+    auto corner = tensor::slice(matrix, {tensor::Range{0, 4}, tensor::Range{0, 4}});
+    assert(corner.volume() == 16 and corner.size() == 3 and corner.at(3, 3) == 3);
+    try
+    {
+        (void) corner.at(7, 7);
+        assert(false);
+    }
+    catch (const std::out_of_range& ex)
+    {
+        assert(std::strlen(ex.what()) > 0);
+    }
+    try
+    {
+        corner.set({100, 100}, 1);
+        assert(false);
+    }
+    catch (const std::out_of_range&)
+    {
+        assert(matrix.at(100, 100) == DFLT);
+    }
+
+    const auto csr = tensor::to_csr(matrix);
+    assert(csr.rows == (SIZE+1) and csr.cols == (SIZE+1) and csr.nnz() == (SIZE+SIZE));
+    assert(csr.row_ptr.front() == 0 and csr.row_ptr.back() == csr.nnz());
+
+    const auto ones = std::vector<TYPE>((SIZE+1), 1);
+    const auto spmv = tensor::spmv(csr, ones);
+    assert(std::all_of(spmv.cbegin(), spmv.cend(), [](const TYPE val) { return val == SIZE; }));
+    assert(tensor::spmm(csr, ones, 1) == spmv);
+
+    auto shifted = tensor::Tensor<TYPE, 1, RANK>{};
+    shifted[0][1] = 3;
+    shifted[1][0] = 5;
+    const auto shifted_csr = tensor::to_csr(shifted);
+    assert(tensor::spmv(shifted_csr, std::vector<TYPE>{1, 2}) == (std::vector<TYPE>{7, 7}));
+    const auto padded_csr = tensor::to_csr(shifted, 3, 3);
+    assert(padded_csr.rows == 3 and padded_csr.row_ptr.size() == 4 and padded_csr.row_ptr.back() == 2);
+    assert(tensor::spmv(padded_csr, std::vector<TYPE>{1, 2, 3}) == (std::vector<TYPE>{10, 10, 6}));
+    assert(tensor::spmm(padded_csr, std::vector<TYPE>{1, 2, 3}, 1) == (std::vector<TYPE>{10, 10, 6}));
+    try
+    {
+        (void) tensor::spmv(padded_csr, std::vector<TYPE>{1, 2});
+        assert(false);
+    }
+    catch (const tensor::Exception::DimensionMismatch&)
+    {
+    }
+    try
+    {
+        (void) tensor::spmv(shifted_csr, std::vector<TYPE>{1, 2, 3});
+        assert(false);
+    }
+    catch (const tensor::Exception::DimensionMismatch&)
+    {
+    }
+    try
+    {
+        (void) tensor::to_csr(shifted, 1, 1);
+        assert(false);
+    }
+    catch (const tensor::Exception::DimensionMismatch&)
+    {
+    }
+
+    auto dense = tensor::Tensor<TYPE, DFLT, RANK>{};
+    for (auto i{0}; i < 256; ++i)
+    {
+        for (auto k{0}; k < 256; ++k)
+        {
+            dense[i][k] = (i ^ k) + 1;
+        }
+    }
+    const auto dense_csr = tensor::to_csr(dense);
+    const auto dense_vec = std::vector<TYPE>(256, 2);
+    assert(tensor::spmv(dense_csr, dense_vec, 1) == tensor::spmv(dense_csr, dense_vec, 4));
+
+    auto cube = tensor::Tensor<TYPE, DFLT, 3>{};
+    cube[2][0][1] = 1;
+    cube[0][5][5] = 2;
+    const auto coo = tensor::to_coo(cube);
+    assert(coo.nnz() == 2 and coo.values.front() == 2 and coo.coords.back()[0] == 2);
+
+    const auto plane = tensor::project<1>(cube, 5);
+    assert(plane.size() == 1 and plane.at(0, 5) == 2);
+
+    const bool probed = probe::enabled();
+    probe::enable(true);
+    auto& inserts = probe::registry::instance().counter_at("tensor.store.insert");
+    auto& removes = probe::registry::instance().counter_at("tensor.store.remove");
+    const auto inserted = inserts.value();
+    const auto removed  = removes.value();
+    auto probe_matrix = tensor::Tensor<TYPE, DFLT, 2>{};
+    probe_matrix[1][1] = 1;
+    probe_matrix[1][1] = 2;
+    probe_matrix[2][2] = 3;
+    probe_matrix[1][1] = DFLT;
+    assert(inserts.value() == inserted + 2 and removes.value() == removed + 1);
+    probe::enable(probed);
 }
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+
+#include <iface.hpp>
+#include <store.hpp>
+
+namespace tensor {
+
+// Sparse tensor of dense Edge^Rank tiles: a tile is allocated on first non-default
+// write and freed as soon as all of its cells fall back to Default.
+template<typename T, T Default = T{}, std::size_t Rank = 2, std::size_t Edge = 8>
+class BlockTensor final
+{
+
+public:
+
+    static_assert(Rank > 0, "block tensor should have at least one index");
+    static_assert(Edge > 0, "block edge should not be empty");
+
+    using Idx   = typename ITensor<T>::Idx;
+    using Coord = std::array<Idx, Rank>;
+
+    static constexpr T default_value = Default;
+    static constexpr std::size_t rank = Rank;
+    static constexpr std::size_t edge = Edge;
+
+    static constexpr std::size_t block_cells = []()
+    {
+        std::size_t acc = 1;
+        for (std::size_t it{0}; it < Rank; ++it)
+        {
+            acc *= Edge;
+        }
+        return acc;
+    }();
+
+    struct alignas(64) Block
+    {
+        Block() noexcept
+        {
+            cells.fill(Default);
+        }
+
+        std::array<T, block_cells> cells;
+        std::size_t count = {};
+    };
+
+    std::size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    std::size_t blocks() const noexcept
+    {
+        return m_blocks.size();
+    }
+
+    template<typename... I>
+    T at(const I... idx) const noexcept
+    {
+        static_assert(sizeof...(I) == Rank, "number of indices should match tensor rank");
+        return get(Coord{static_cast<Idx>(idx)...});
+    }
+
+    T get(const Coord& coord) const noexcept
+    {
+        const auto [key, off] = split(coord);
+        const auto it = m_blocks.find(key);
+
+        return (it != m_blocks.end()) ? it->second.cells[off] : Default;
+    }
+
+    void set(const Coord& coord, const T val)
+    {
+        const auto [key, off] = split(coord);
+
+        if (val == Default)
+        {
+            const auto it = m_blocks.find(key);
+
+            if ((it != m_blocks.end()) and (it->second.cells[off] != Default))
+            {
+                it->second.cells[off] = Default;
+                m_size -= 1;
+
+                if (--it->second.count == 0)
+                {
+                    m_blocks.erase(it);
+                }
+            }
+        }
+        else
+        {
+            auto& block = m_blocks[key];
+
+            if (block.cells[off] == Default)
+            {
+                block.count += 1;
+                m_size += 1;
+            }
+
+            block.cells[off] = val;
+        }
+    }
+
+    template<typename Fn>
+    void for_each(Fn&& fn) const
+    {
+        for (const auto& [key, block]: m_blocks)
+        {
+            for (std::size_t off{0}; off < block_cells; ++off)
+            {
+                if (block.cells[off] != Default)
+                {
+                    fn(static_cast<const Coord&>(join(key, off)), block.cells[off]);
+                }
+            }
+        }
+    }
+
+    // Visits every allocated tile with the coordinate of its first cell, cells are row-major.
+    template<typename Fn>
+    void for_each_block(Fn&& fn) const
+    {
+        for (const auto& [key, block]: m_blocks)
+        {
+            fn(static_cast<const Coord&>(join(key, 0)), block);
+        }
+    }
+
+private:
+
+    static std::pair<Coord, std::size_t> split(const Coord& coord) noexcept
+    {
+        auto key = Coord{};
+        auto off = std::size_t{0};
+
+        for (std::size_t dim{0}; dim < Rank; ++dim)
+        {
+            key[dim] = coord[dim] / Edge;
+            off = (off * Edge) + (coord[dim] % Edge);
+        }
+
+        return {key, off};
+    }
+
+    static Coord join(const Coord& key, std::size_t off) noexcept
+    {
+        auto coord = Coord{};
+
+        for (std::size_t dim{Rank}; dim > 0; --dim)
+        {
+            coord[dim - 1] = (key[dim - 1] * Edge) + (off % Edge);
+            off /= Edge;
+        }
+
+        return coord;
+    }
+
+    std::unordered_map<Coord, Block, CoordHash<Rank>> m_blocks = {};
+    std::size_t m_size = {};
+
+};
+
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+
+#include <iface.hpp>
+#include <store.hpp>
+#include <tensor.hpp>
+
+namespace tensor {
+
+template<typename T, T Default = T{}, std::size_t Rank = 3, std::size_t Shards = 64>
+class ConcurrentTensor final
+{
+
+public:
+
+    static_assert(Rank > 0, "concurrent tensor should have at least one index");
+    static_assert(Shards > 0, "concurrent tensor should have at least one shard");
+
+    using Store = ItemStore<T, Default, Rank>;
+    using Coord = typename Store::Coord;
+
+    static constexpr T default_value = Default;
+    static constexpr std::size_t rank = Rank;
+
+    std::size_t size() const
+    {
+        decltype(size()) acc = {};
+
+        for (const auto& shard: m_shards)
+        {
+            const auto lock = std::shared_lock{shard.mutex};
+            acc += shard.store.size();
+        }
+
+        return acc;
+    }
+
+    template<typename... Idx>
+    T at(const Idx... idx) const
+    {
+        static_assert(sizeof...(Idx) == Rank, "number of indices should match tensor rank");
+        return get(Coord{static_cast<typename ITensor<T>::Idx>(idx)...});
+    }
+
+    T get(const Coord& coord) const
+    {
+        const auto& shard = shard_of(coord);
+        const auto  lock  = std::shared_lock{shard.mutex};
+
+        return shard.store.get(coord);
+    }
+
+    void set(const Coord& coord, const T val)
+    {
+        auto& shard = shard_of(coord);
+        const auto lock = std::unique_lock{shard.mutex};
+
+        shard.store.set(coord, val);
+    }
+
+    // Returns the value after update, the cell is erased once it reaches Default.
+    T add(const Coord& coord, const T delta)
+    {
+        auto& shard = shard_of(coord);
+        const auto lock = std::unique_lock{shard.mutex};
+
+        return shard.store.add(coord, delta);
+    }
+
+    // Each shard is visited under its own lock, so the walk is consistent per shard only.
+    template<typename Fn>
+    void for_each(Fn&& fn) const
+    {
+        for (const auto& shard: m_shards)
+        {
+            const auto lock = std::shared_lock{shard.mutex};
+            shard.store.for_each(fn);
+        }
+    }
+
+    auto freeze() const -> Tensor<T, Default, Rank>
+    {
+        auto out = Tensor<T, Default, Rank>{};
+
+        for_each([&out](const Coord& coord, const T val)
+        {
+            out.set(coord, val);
+        });
+
+        return out;
+    }
+
+private:
+
+    struct alignas(64) Shard
+    {
+        mutable std::shared_mutex mutex = {};
+        Store store{};
+    };
+
+    static std::size_t shard_idx(const Coord& coord) noexcept
+    {
+        const auto hash = CoordHash<Rank>{}(coord);
+        return (hash ^ (hash >> 32)) % Shards;
+    }
+
+    Shard& shard_of(const Coord& coord) noexcept
+    {
+        return m_shards[shard_idx(coord)];
+    }
+
+    const Shard& shard_of(const Coord& coord) const noexcept
+    {
+        return m_shards[shard_idx(coord)];
+    }
+
+    std::array<Shard, Shards> m_shards = {};
+
+};
+
+}
@@ -0,0 +1,405 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include <iface.hpp>
+
+namespace tensor {
+
+struct ExprBase
+{};
+
+template<typename E>
+inline constexpr bool is_expr_v = std::is_base_of_v<ExprBase, E>;
+
+template<typename S, typename = void>
+struct is_source: std::false_type
+{};
+
+// Anything exposing `default_value`, `rank`, `get(coord)` and `for_each(fn)` is a sparse source.
+template<typename S>
+struct is_source<S, std::void_t<decltype(S::default_value), decltype(S::rank)>>
+    : std::bool_constant<(S::rank > 0) and (not is_expr_v<S>)>
+{};
+
+template<typename S>
+inline constexpr bool is_source_v = is_source<S>::value;
+
+inline constexpr std::size_t ANY_RANK = std::numeric_limits<std::size_t>::max();
+
+enum class Support
+{
+    Union,
+    Lhs,
+    Rhs,
+    Intersection,
+};
+
+template<typename S>
+class Leaf: public ExprBase
+{
+
+public:
+
+    using value_type = std::remove_cv_t<decltype(S::default_value)>;
+
+    static constexpr std::size_t rank = S::rank;
+
+    explicit Leaf(const S& src) noexcept
+        : m_src{src}
+    {}
+
+    value_type dflt() const noexcept
+    {
+        return S::default_value;
+    }
+
+    template<typename Coord>
+    value_type get(const Coord& coord) const
+    {
+        return m_src.get(coord);
+    }
+
+    template<typename Coord>
+    bool occupied(const Coord& coord) const
+    {
+        return m_src.get(coord) != S::default_value;
+    }
+
+    template<typename Fn>
+    void for_each_occupied(Fn&& fn) const
+    {
+        m_src.for_each([&fn](const auto& coord, const value_type)
+        {
+            fn(coord);
+        });
+    }
+
+private:
+
+    const S& m_src;
+
+};
+
+template<typename T>
+class Const: public ExprBase
+{
+
+public:
+
+    using value_type = T;
+
+    static constexpr std::size_t rank = ANY_RANK;
+
+    explicit Const(const T val) noexcept
+        : m_val{val}
+    {}
+
+    T dflt() const noexcept
+    {
+        return m_val;
+    }
+
+    template<typename Coord>
+    T get(const Coord&) const noexcept
+    {
+        return m_val;
+    }
+
+    template<typename Coord>
+    bool occupied(const Coord&) const noexcept
+    {
+        return false;
+    }
+
+    template<typename Fn>
+    void for_each_occupied(Fn&&) const noexcept
+    {}
+
+private:
+
+    const T m_val;
+
+};
+
+struct Add
+{
+    template<typename T>
+    static T apply(const T lhs, const T rhs) noexcept
+    {
+        return lhs + rhs;
+    }
+
+    template<typename T>
+    static Support support(const T, const T) noexcept
+    {
+        return Support::Union;
+    }
+};
+
+struct Sub
+{
+    template<typename T>
+    static T apply(const T lhs, const T rhs) noexcept
+    {
+        return lhs - rhs;
+    }
+
+    template<typename T>
+    static Support support(const T, const T) noexcept
+    {
+        return Support::Union;
+    }
+};
+
+// Element-wise (Hadamard) product, a zero default on either side bounds the result support.
+struct Mul
+{
+    template<typename T>
+    static T apply(const T lhs, const T rhs) noexcept
+    {
+        return lhs * rhs;
+    }
+
+    template<typename T>
+    static Support support(const T lhs_dflt, const T rhs_dflt) noexcept
+    {
+        if ((lhs_dflt == T{}) and (rhs_dflt == T{}))
+        {
+            return Support::Intersection;
+        }
+        if (lhs_dflt == T{})
+        {
+            return Support::Lhs;
+        }
+        if (rhs_dflt == T{})
+        {
+            return Support::Rhs;
+        }
+        return Support::Union;
+    }
+};
+
+template<typename Op, typename L, typename R>
+class Binary: public ExprBase
+{
+
+public:
+
+    using value_type = std::conditional_t<(L::rank == ANY_RANK),
+        typename R::value_type, typename L::value_type>;
+
+    static constexpr std::size_t rank = (L::rank == ANY_RANK) ? R::rank : L::rank;
+
+    static_assert((L::rank == ANY_RANK) or (R::rank == ANY_RANK) or (L::rank == R::rank),
+                  "operand ranks should match");
+    static_assert(std::is_same_v<typename L::value_type, typename R::value_type>,
+                  "operand value types should match");
+
+    Binary(L lhs, R rhs) noexcept
+        : m_lhs{std::move(lhs)}
+        , m_rhs{std::move(rhs)}
+        , m_dflt{Op::apply(m_lhs.dflt(), m_rhs.dflt())}
+        , m_support{Op::support(m_lhs.dflt(), m_rhs.dflt())}
+    {}
+
+    value_type dflt() const noexcept
+    {
+        return m_dflt;
+    }
+
+    template<typename Coord>
+    value_type get(const Coord& coord) const
+    {
+        return Op::apply(m_lhs.get(coord), m_rhs.get(coord));
+    }
+
+    template<typename Coord>
+    bool occupied(const Coord& coord) const
+    {
+        switch (m_support)
+        {
+            case Support::Lhs:          return m_lhs.occupied(coord);
+            case Support::Rhs:          return m_rhs.occupied(coord);
+            case Support::Intersection: return m_lhs.occupied(coord) and m_rhs.occupied(coord);
+            default:                    return m_lhs.occupied(coord) or  m_rhs.occupied(coord);
+        }
+    }
+
+    // Visits every coordinate that may differ from dflt() exactly once.
+    template<typename Fn>
+    void for_each_occupied(Fn&& fn) const
+    {
+        switch (m_support)
+        {
+            case Support::Lhs:
+                m_lhs.for_each_occupied(fn);
+                break;
+            case Support::Rhs:
+                m_rhs.for_each_occupied(fn);
+                break;
+            case Support::Intersection:
+                m_lhs.for_each_occupied([this, &fn](const auto& coord)
+                {
+                    if (m_rhs.occupied(coord))
+                    {
+                        fn(coord);
+                    }
+                });
+                break;
+            default:
+                m_lhs.for_each_occupied(fn);
+                m_rhs.for_each_occupied([this, &fn](const auto& coord)
+                {
+                    if (not m_lhs.occupied(coord))
+                    {
+                        fn(coord);
+                    }
+                });
+                break;
+        }
+    }
+
+private:
+
+    const L m_lhs;
+    const R m_rhs;
+
+    const value_type m_dflt;
+    const Support    m_support;
+
+};
+
+template<typename X, typename T>
+auto as_expr(const X& x)
+{
+    if constexpr (is_expr_v<X>)
+    {
+        return x;
+    }
+    else if constexpr (is_source_v<X>)
+    {
+        return Leaf<X>{x};
+    }
+    else
+    {
+        return Const<T>{static_cast<T>(x)};
+    }
+}
+
+template<typename X>
+inline constexpr bool is_operand_v = is_expr_v<X> or is_source_v<X>;
+
+template<typename X, typename = void>
+struct operand_value
+{
+    using type = X;
+};
+
+template<typename X>
+struct operand_value<X, std::enable_if_t<is_expr_v<X>>>
+{
+    using type = typename X::value_type;
+};
+
+template<typename X>
+struct operand_value<X, std::enable_if_t<is_source_v<X>>>
+{
+    using type = std::remove_cv_t<decltype(X::default_value)>;
+};
+
+template<typename Op, typename L, typename R>
+auto make_binary(const L& lhs, const R& rhs)
+{
+    using T = typename operand_value<std::conditional_t<is_operand_v<L>, L, R>>::type;
+
+    using LE = decltype(as_expr<L, T>(lhs));
+    using RE = decltype(as_expr<R, T>(rhs));
+
+    return Binary<Op, LE, RE>{as_expr<L, T>(lhs), as_expr<R, T>(rhs)};
+}
+
+template<typename L, typename R>
+inline constexpr bool is_binary_v = (is_operand_v<L> or is_operand_v<R>) and
+    (is_operand_v<L> or std::is_arithmetic_v<L>) and
+    (is_operand_v<R> or std::is_arithmetic_v<R>);
+
+template<typename L, typename R, typename std::enable_if_t<is_binary_v<L, R>, bool> = true>
+auto operator+(const L& lhs, const R& rhs)
+{
+    return make_binary<Add>(lhs, rhs);
+}
+
+template<typename L, typename R, typename std::enable_if_t<is_binary_v<L, R>, bool> = true>
+auto operator-(const L& lhs, const R& rhs)
+{
+    return make_binary<Sub>(lhs, rhs);
+}
+
+template<typename L, typename R, typename std::enable_if_t<is_binary_v<L, R>, bool> = true>
+auto operator*(const L& lhs, const R& rhs)
+{
+    return make_binary<Mul>(lhs, rhs);
+}
+
+template<typename L, typename R, typename std::enable_if_t<is_binary_v<L, R>, bool> = true>
+auto hadamard(const L& lhs, const R& rhs)
+{
+    return make_binary<Mul>(lhs, rhs);
+}
+
+// Folds `fn(acc, val)` over every cell whose value differs from the expression default.
+template<typename X, typename Acc, typename Fn>
+Acc reduce(const X& x, Acc acc, Fn&& fn)
+{
+    using T = typename operand_value<X>::type;
+
+    const auto expr = as_expr<X, T>(x);
+    const auto dflt = expr.dflt();
+
+    expr.for_each_occupied([&](const auto& coord)
+    {
+        const auto val = expr.get(coord);
+
+        if (val != dflt)
+        {
+            acc = fn(acc, val);
+        }
+    });
+
+    return acc;
+}
+
+template<typename X, typename std::enable_if_t<is_operand_v<X>, bool> = true>
+std::size_t nnz(const X& x)
+{
+    return reduce(x, std::size_t{0}, [](const std::size_t acc, const auto) { return acc + 1; });
+}
+
+template<typename X, typename std::enable_if_t<is_operand_v<X>, bool> = true>
+auto sum(const X& x)
+{
+    using T = typename operand_value<X>::type;
+    return reduce(x, T{}, [](const T acc, const T val) { return static_cast<T>(acc + val); });
+}
+
+// Unoccupied cells hold the default, so it always takes part in max/min.
+template<typename X, typename std::enable_if_t<is_operand_v<X>, bool> = true>
+auto max(const X& x)
+{
+    using T = typename operand_value<X>::type;
+    return reduce(x, as_expr<X, T>(x).dflt(), [](const T acc, const T val) { return std::max(acc, val); });
+}
+
+template<typename X, typename std::enable_if_t<is_operand_v<X>, bool> = true>
+auto min(const X& x)
+{
+    using T = typename operand_value<X>::type;
+    return reduce(x, as_expr<X, T>(x).dflt(), [](const T acc, const T val) { return std::min(acc, val); });
+}
+
+}
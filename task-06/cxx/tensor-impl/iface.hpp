@@ -28,6 +28,27 @@ struct Exception: std::exception
             : std::invalid_argument{"vector does not support conversion to value"}
         {}
     };
+
+    struct DimensionMismatch: std::invalid_argument
+    {
+        DimensionMismatch()
+            : std::invalid_argument{"operand dimensions do not match"}
+        {}
+    };
+
+    struct DefaultMismatch: std::invalid_argument
+    {
+        DefaultMismatch()
+            : std::invalid_argument{"expression default does not match tensor default"}
+        {}
+    };
+
+    struct BadSnapshot: std::runtime_error
+    {
+        BadSnapshot()
+            : std::runtime_error{"snapshot file is missing or malformed"}
+        {}
+    };
 };
 
 template<typename T>
@@ -39,6 +60,8 @@ public:
     using Idx = std::size_t;
     using Ptr = std::shared_ptr<ITensor<T>>;
 
+    virtual ~ITensor() = default;
+
     virtual std::size_t size() const = 0;
     virtual ITensor<T>& operator[](Idx) = 0;
     virtual void operator=(T) = 0;
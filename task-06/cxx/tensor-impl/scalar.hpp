@@ -1,24 +1,28 @@
 #pragma once
 
-#include <memory>
-#include <optional>
-#include <variant>
+#include <cstddef>
 
 #include <iface.hpp>
 #include <store.hpp>
 
 namespace tensor {
 
-template<typename T, T Default = T{}>
-class Scalar: public ItemStore<T>
+template<typename T, T Default, std::size_t Rank>
+class Scalar final: public ITensor<T>
 {
 
 public:
 
-    explicit Scalar(typename ItemStore<T>::ParentOpt parent = {}) noexcept
-        : ItemStore<T>{std::move(parent)}
+    using Store = ItemStore<T, Default, Rank>;
+
+    Scalar(Store& store, const typename Store::Coord& coord) noexcept
+        : m_store{store}
+        , m_coord{coord}
+    {}
+
+    std::size_t size() const override
     {
-        this->insert(SCALAR_IDX, Default);
+        return m_store.has(m_coord) ? 1 : 0;
     }
 
     ITensor<T>& operator[](const typename ITensor<T>::Idx) override
@@ -28,32 +32,19 @@ public:
 
     void operator=(const T val) override
     {
-        if ((val == Default) and this->parent().has_value())
-        {
-            this->remove(SCALAR_IDX);
-        }
-        else
-        {
-            this->insert(SCALAR_IDX, val);
-        }
+        m_store.set(m_coord, val);
     }
 
     operator T() override
     {
-        const auto scalar_itm = this->item(SCALAR_IDX);
-        const auto scalar_val = std::get<T>(scalar_itm);
-
-        if ((scalar_val == Default) and this->parent().has_value())
-        {
-            this->remove(SCALAR_IDX);
-        }
-
-        return scalar_val;
+        return m_store.get(m_coord);
     }
 
 private:
 
-    static constexpr typename ITensor<T>::Idx SCALAR_IDX{0};
+    Store& m_store;
+    const typename Store::Coord m_coord;
+
 };
 
 }
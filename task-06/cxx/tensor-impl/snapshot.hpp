@@ -0,0 +1,257 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <iface.hpp>
+#include <sparse.hpp>
+#include <tensor.hpp>
+
+namespace tensor {
+
+// On-disk layout: Header, then nnz coordinates of Rank indices each in
+// lexicographic order, then nnz values in the same order. Everything is in host byte
+// order; `order` holds ORDER as written, so a snapshot from a foreign-endian host is rejected.
+struct SnapshotHeader
+{
+    static constexpr std::array<char, 8> MAGIC = {'T', 'E', 'N', 'S', 'O', 'R', '\x00', '\x02'};
+    static constexpr std::uint64_t ORDER = 0x0102030405060708ULL;
+
+    std::array<char, 8> magic = MAGIC;
+
+    std::uint64_t rank       = {};
+    std::uint64_t idx_bytes  = {};
+    std::uint64_t val_bytes  = {};
+    std::uint64_t val_signed = {};
+    std::uint64_t nnz        = {};
+
+    std::array<std::byte, 8> dflt = {};
+
+    std::uint64_t order = ORDER;
+};
+
+static_assert(sizeof(SnapshotHeader) == 64);
+
+template<typename T, T Default>
+SnapshotHeader snapshot_header(const std::size_t rank, const std::size_t nnz) noexcept
+{
+    static_assert(sizeof(T) <= sizeof(SnapshotHeader::dflt));
+
+    auto head = SnapshotHeader{};
+    head.rank       = rank;
+    head.idx_bytes  = sizeof(typename ITensor<T>::Idx);
+    head.val_bytes  = sizeof(T);
+    head.val_signed = std::is_signed_v<T>;
+    head.nnz        = nnz;
+
+    const T dflt = Default;
+    std::memcpy(head.dflt.data(), &dflt, sizeof(T));
+
+    return head;
+}
+
+// Total file size for nnz cells; throws BadSnapshot when it does not fit into std::size_t.
+template<typename T, std::size_t Rank>
+std::size_t snapshot_bytes(const std::uint64_t nnz)
+{
+    constexpr auto cell = sizeof(typename Coo<T, Rank>::Coord) + sizeof(T);
+    constexpr auto most = (std::numeric_limits<std::size_t>::max() - sizeof(SnapshotHeader)) / cell;
+
+    if (nnz > most)
+    {
+        throw Exception::BadSnapshot{};
+    }
+
+    return sizeof(SnapshotHeader) + static_cast<std::size_t>(nnz) * cell;
+}
+
+template<typename T, T Default, std::size_t Rank>
+void save(const Tensor<T, Default, Rank>& tensor, const std::string& path)
+{
+    static_assert(Rank > 0, "snapshot should have at least one index");
+
+    const auto coo  = to_coo(tensor);
+    const auto head = snapshot_header<T, Default>(Rank, coo.nnz());
+
+    if (snapshot_bytes<T, Rank>(coo.nnz()) > static_cast<std::size_t>(std::numeric_limits<std::streamsize>::max()))
+    {
+        throw Exception::BadSnapshot{};
+    }
+
+    auto out = std::ofstream{path, std::ios::binary | std::ios::trunc};
+
+    out.write(reinterpret_cast<const char*>(&head), sizeof(head));
+    out.write(reinterpret_cast<const char*>(coo.coords.data()), coo.nnz() * sizeof(typename Coo<T, Rank>::Coord));
+    out.write(reinterpret_cast<const char*>(coo.values.data()), coo.nnz() * sizeof(T));
+
+    if (not out.flush())
+    {
+        throw Exception::BadSnapshot{};
+    }
+}
+
+// Read-only tensor backed by a memory-mapped snapshot file.
+template<typename T, T Default = T{}, std::size_t Rank = 3>
+class Snapshot final
+{
+
+public:
+
+    static_assert(Rank > 0, "snapshot should have at least one index");
+
+    using Idx   = typename ITensor<T>::Idx;
+    using Coord = std::array<Idx, Rank>;
+
+    static constexpr T default_value = Default;
+    static constexpr std::size_t rank = Rank;
+
+    explicit Snapshot(const std::string& path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw Exception::BadSnapshot{};
+        }
+
+        struct stat info = {};
+        const bool sized = (::fstat(fd, &info) == 0) and (static_cast<std::size_t>(info.st_size) >= sizeof(SnapshotHeader));
+
+        if (sized)
+        {
+            m_bytes = static_cast<std::size_t>(info.st_size);
+            m_map   = ::mmap(nullptr, m_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+
+        ::close(fd);
+
+        if ((not sized) or (m_map == MAP_FAILED))
+        {
+            m_map = nullptr;
+            throw Exception::BadSnapshot{};
+        }
+
+        const auto* const base = static_cast<const std::byte*>(m_map);
+        const auto* const head = reinterpret_cast<const SnapshotHeader*>(base);
+        const auto expect = snapshot_header<T, Default>(Rank, head->nnz);
+
+        const auto fits = head->nnz <= (std::numeric_limits<std::size_t>::max() - sizeof(SnapshotHeader))
+                                     / (sizeof(Coord) + sizeof(T));
+
+        if ((not fits) or std::memcmp(head, &expect, sizeof(SnapshotHeader)) != 0
+            or (m_bytes != snapshot_bytes<T, Rank>(head->nnz)))
+        {
+            release();
+            throw Exception::BadSnapshot{};
+        }
+
+        m_nnz    = head->nnz;
+        m_coords = reinterpret_cast<const Coord*>(base + sizeof(SnapshotHeader));
+        m_values = reinterpret_cast<const T*>(base + sizeof(SnapshotHeader) + m_nnz * sizeof(Coord));
+    }
+
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    Snapshot(Snapshot&& rhs) noexcept
+        : m_map   {std::exchange(rhs.m_map, nullptr)}
+        , m_bytes {std::exchange(rhs.m_bytes, 0)}
+        , m_nnz   {std::exchange(rhs.m_nnz, 0)}
+        , m_coords{std::exchange(rhs.m_coords, nullptr)}
+        , m_values{std::exchange(rhs.m_values, nullptr)}
+    {}
+
+    Snapshot& operator=(Snapshot&& rhs) noexcept
+    {
+        if (&rhs != this)
+        {
+            release();
+            m_map    = std::exchange(rhs.m_map, nullptr);
+            m_bytes  = std::exchange(rhs.m_bytes, 0);
+            m_nnz    = std::exchange(rhs.m_nnz, 0);
+            m_coords = std::exchange(rhs.m_coords, nullptr);
+            m_values = std::exchange(rhs.m_values, nullptr);
+        }
+        return (*this);
+    }
+
+    ~Snapshot()
+    {
+        release();
+    }
+
+    std::size_t size() const noexcept
+    {
+        return m_nnz;
+    }
+
+    template<typename... I>
+    T at(const I... idx) const noexcept
+    {
+        static_assert(sizeof...(I) == Rank, "number of indices should match tensor rank");
+        return get(Coord{static_cast<Idx>(idx)...});
+    }
+
+    // O(logN)
+    T get(const Coord& coord) const noexcept
+    {
+        std::size_t lo = 0;
+        std::size_t hi = m_nnz;
+
+        while (lo < hi)
+        {
+            const auto mid = lo + (hi - lo) / 2;
+
+            if (m_coords[mid] < coord)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+
+        return ((lo < m_nnz) and (m_coords[lo] == coord)) ? m_values[lo] : Default;
+    }
+
+    template<typename Fn>
+    void for_each(Fn&& fn) const
+    {
+        for (std::size_t it{0}; it < m_nnz; ++it)
+        {
+            fn(m_coords[it], m_values[it]);
+        }
+    }
+
+private:
+
+    void release() noexcept
+    {
+        if (m_map)
+        {
+            ::munmap(m_map, m_bytes);
+            m_map = nullptr;
+        }
+    }
+
+    void*       m_map    = nullptr;
+    std::size_t m_bytes  = {};
+    std::size_t m_nnz    = {};
+    const Coord* m_coords = nullptr;
+    const T*     m_values = nullptr;
+
+};
+
+}
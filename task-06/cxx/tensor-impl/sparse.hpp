@@ -0,0 +1,260 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <numeric>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <iface.hpp>
+#include <tensor.hpp>
+
+namespace tensor {
+
+template<typename T, std::size_t Rank>
+struct Coo
+{
+    using Idx   = typename ITensor<T>::Idx;
+    using Coord = std::array<Idx, Rank>;
+
+    std::vector<Coord> coords = {};
+    std::vector<T>     values = {};
+
+    T dflt = {};
+
+    std::size_t nnz() const noexcept
+    {
+        return values.size();
+    }
+};
+
+template<typename T>
+struct Csr
+{
+    using Idx = typename ITensor<T>::Idx;
+
+    std::size_t rows = {};
+    std::size_t cols = {};
+
+    std::vector<std::size_t> row_ptr = {};
+    std::vector<Idx>         col_idx = {};
+    std::vector<T>           values  = {};
+
+    T dflt = {};
+
+    std::size_t nnz() const noexcept
+    {
+        return values.size();
+    }
+};
+
+namespace detail {
+
+constexpr std::size_t SPARSE_PARALLEL_NNZ = (1U << 16);
+
+// Splits rows into chunks of roughly equal non-zero count and runs `fn(row_beg, row_end)` per chunk.
+template<typename T, typename Fn>
+void for_row_chunks(const Csr<T>& mtx, std::size_t threads, Fn&& fn)
+{
+    if (threads == 0)
+    {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    if ((threads == 1) or (mtx.nnz() < SPARSE_PARALLEL_NNZ) or (mtx.rows < threads))
+    {
+        fn(std::size_t{0}, mtx.rows);
+        return;
+    }
+
+    auto workers = std::vector<std::thread>{};
+    auto row_beg = std::size_t{0};
+
+    for (std::size_t part{1}; part <= threads; ++part)
+    {
+        const auto nnz_end = (mtx.nnz() * part) / threads;
+        const auto row_end = (part == threads) ? mtx.rows : static_cast<std::size_t>(
+            std::lower_bound(mtx.row_ptr.cbegin(), mtx.row_ptr.cend(), nnz_end) - mtx.row_ptr.cbegin());
+
+        if (row_end > row_beg)
+        {
+            workers.emplace_back(fn, row_beg, row_end);
+            row_beg = row_end;
+        }
+    }
+
+    for (auto& worker: workers)
+    {
+        worker.join();
+    }
+}
+
+}
+
+template<typename T, T Default, std::size_t Rank>
+auto to_coo(const Tensor<T, Default, Rank>& tensor) -> Coo<T, Rank>
+{
+    using Cell = std::pair<typename Coo<T, Rank>::Coord, T>;
+
+    auto cells = std::vector<Cell>{};
+    cells.reserve(tensor.size());
+
+    tensor.for_each([&cells](const auto& coord, const T val)
+    {
+        cells.emplace_back(coord, val);
+    });
+
+    std::sort(cells.begin(), cells.end(), [](const Cell& lhs, const Cell& rhs)
+    {
+        return lhs.first < rhs.first;
+    });
+
+    auto coo = Coo<T, Rank>{};
+    coo.dflt = Default;
+    coo.coords.reserve(cells.size());
+    coo.values.reserve(cells.size());
+
+    for (const auto& [coord, val]: cells)
+    {
+        coo.coords.push_back(coord);
+        coo.values.push_back(val);
+    }
+
+    return coo;
+}
+
+// Builds a rows x cols CSR matrix; coordinates outside that shape throw DimensionMismatch.
+template<typename T, T Default>
+auto to_csr(const Tensor<T, Default, 2>& tensor, const std::size_t rows, const std::size_t cols) -> Csr<T>
+{
+    const auto coo = to_coo(tensor);
+
+    auto csr = Csr<T>{};
+    csr.rows = rows;
+    csr.cols = cols;
+    csr.dflt = Default;
+
+    csr.row_ptr.assign((csr.rows + 1), 0);
+    csr.col_idx.reserve(coo.nnz());
+    csr.values = coo.values;
+
+    for (const auto& [row, col]: coo.coords)
+    {
+        if ((row >= csr.rows) or (col >= csr.cols))
+        {
+            throw Exception::DimensionMismatch{};
+        }
+
+        csr.row_ptr[row + 1] += 1;
+        csr.col_idx.push_back(col);
+    }
+
+    std::partial_sum(csr.row_ptr.cbegin(), csr.row_ptr.cend(), csr.row_ptr.begin());
+
+    return csr;
+}
+
+// Infers the shape from the largest occupied coordinate. Trailing rows or columns that hold only
+// Default are dropped, so pass the logical shape explicitly when it matters (e.g. Default != 0).
+template<typename T, T Default>
+auto to_csr(const Tensor<T, Default, 2>& tensor) -> Csr<T>
+{
+    auto rows = std::size_t{0};
+    auto cols = std::size_t{0};
+
+    tensor.for_each([&rows, &cols](const auto& coord, const T)
+    {
+        rows = std::max(rows, static_cast<std::size_t>(coord[0] + 1));
+        cols = std::max(cols, static_cast<std::size_t>(coord[1] + 1));
+    });
+
+    return to_csr(tensor, rows, cols);
+}
+
+// y = A * x, where every cell absent from A reads as A.dflt.
+template<typename T>
+auto spmv(const Csr<T>& mtx, const std::vector<T>& vec, const std::size_t threads = 0) -> std::vector<T>
+{
+    if (vec.size() != mtx.cols)
+    {
+        throw Exception::DimensionMismatch{};
+    }
+
+    const auto base = (mtx.dflt == T{}) ? T{} : static_cast<T>(
+        mtx.dflt * std::accumulate(vec.cbegin(), vec.cend(), T{}));
+
+    auto out = std::vector<T>(mtx.rows, base);
+
+    detail::for_row_chunks(mtx, threads, [&](const std::size_t row_beg, const std::size_t row_end)
+    {
+        const auto* const col_idx = mtx.col_idx.data();
+        const auto* const values  = mtx.values.data();
+        const auto* const vec_ptr = vec.data();
+
+        for (auto row = row_beg; row < row_end; ++row)
+        {
+            auto acc = T{};
+
+            for (auto k = mtx.row_ptr[row]; k < mtx.row_ptr[row + 1]; ++k)
+            {
+                acc += (values[k] - mtx.dflt) * vec_ptr[col_idx[k]];
+            }
+
+            out[row] += acc;
+        }
+    });
+
+    return out;
+}
+
+// Y = A * X, where X is a row-major (vec.size() / width) x width dense matrix.
+template<typename T>
+auto spmm(const Csr<T>& mtx, const std::vector<T>& vec, const std::size_t width,
+          const std::size_t threads = 0) -> std::vector<T>
+{
+    if ((width == 0) or (vec.size() % width) or ((vec.size() / width) != mtx.cols))
+    {
+        throw Exception::DimensionMismatch{};
+    }
+
+    auto base = std::vector<T>(width, T{});
+
+    if (mtx.dflt != T{})
+    {
+        for (std::size_t off{0}; off < vec.size(); off += width)
+        {
+            for (std::size_t col{0}; col < width; ++col)
+            {
+                base[col] += mtx.dflt * vec[off + col];
+            }
+        }
+    }
+
+    auto out = std::vector<T>(mtx.rows * width);
+
+    detail::for_row_chunks(mtx, threads, [&](const std::size_t row_beg, const std::size_t row_end)
+    {
+        for (auto row = row_beg; row < row_end; ++row)
+        {
+            auto* const dst = out.data() + (row * width);
+            std::copy(base.cbegin(), base.cend(), dst);
+
+            for (auto k = mtx.row_ptr[row]; k < mtx.row_ptr[row + 1]; ++k)
+            {
+                const auto  val = static_cast<T>(mtx.values[k] - mtx.dflt);
+                const auto* src = vec.data() + (mtx.col_idx[k] * width);
+
+                for (std::size_t col{0}; col < width; ++col)
+                {
+                    dst[col] += val * src[col];
+                }
+            }
+        }
+    });
+
+    return out;
+}
+
+}
@@ -1,113 +1,207 @@
 #pragma once
 
-#include <cassert>
+#include <algorithm>
+#include <array>
 #include <cstddef>
+#include <functional>
 #include <memory>
-#include <optional>
+#include <memory_resource>
+#include <new>
+#include <set>
 #include <unordered_map>
-#include <variant>
+#include <utility>
 
 #include <iface.hpp>
+#include <probe.hpp>
 
 namespace tensor {
 
+template<std::size_t Rank>
+struct CoordHash
+{
+    std::size_t operator()(const std::array<std::size_t, Rank>& coord) const noexcept
+    {
+        std::size_t seed = Rank;
+
+        for (const auto idx: coord)
+        {
+            seed ^= std::hash<std::size_t>{}(idx) + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2);
+        }
+
+        return seed;
+    }
+};
+
 template<typename T>
-class ItemStore: public ITensor<T>
+struct NodeRelease
+{
+    std::pmr::memory_resource* resource = {};
+    std::size_t bytes = {};
+    std::size_t align = {};
+
+    void operator()(ITensor<T>* const node) const noexcept
+    {
+        node->~ITensor<T>();
+        resource->deallocate(node, bytes, align);
+    }
+};
+
+template<typename T>
+using NodePtr = std::unique_ptr<ITensor<T>, NodeRelease<T>>;
+
+template<typename T, typename U, typename... Args>
+auto make_node(std::pmr::memory_resource* const resource, Args&&... args) -> NodePtr<T>
+{
+    void* const mem = resource->allocate(sizeof(U), alignof(U));
+    return NodePtr<T>{new (mem) U(std::forward<Args>(args)...), NodeRelease<T>{resource, sizeof(U), alignof(U)}};
+}
+
+template<typename T, T Default, std::size_t Rank>
+class ItemStore
 {
 
 public:
 
-    std::size_t size() const override
+    using Coord = std::array<typename ITensor<T>::Idx, Rank>;
+
+    explicit ItemStore(std::pmr::memory_resource* const resource = std::pmr::get_default_resource())
+        : m_store{resource}
+    {}
+
+    ItemStore(const ItemStore& rhs, std::pmr::memory_resource* const resource)
+        : m_store{rhs.m_store, resource}
+    {}
+
+    std::pmr::memory_resource* resource() const noexcept
+    {
+        return m_store.get_allocator().resource();
+    }
+
+    std::size_t size() const noexcept
     {
-        decltype(size()) acc = {};
+        return m_store.size();
+    }
 
-        for (auto [_, itm]: m_store)
+    // O(logN + K) for K cells under the first `depth` indices of coord. The first call builds
+    // an ordered index of cells, set() and add() keep it in sync from then on; not thread-safe.
+    std::size_t count_prefix(const Coord& coord, const std::size_t depth) const
+    {
+        if (depth == 0)
         {
-            if (std::holds_alternative<T>(itm))
-            {
-                acc += 1;
-            }
-            else
+            return size();
+        }
+
+        if (not m_order)
+        {
+            m_order = std::make_unique<Order>(resource());
+
+            for (const auto& [cell, _]: m_store)
             {
-                acc += std::get<Ptr>(itm)->size();
+                m_order->insert(cell);
             }
         }
 
-        return acc;
-    }
-
-protected:
+        auto low = coord;
+        std::fill(low.begin() + depth, low.end(), 0);
 
-    struct Parent
-    {
-        typename ItemStore<T>::Ptr ptr;
-        typename ITensor  <T>::Idx idx;
-    };
+        std::size_t acc = 0;
 
-    using Ptr = std::shared_ptr<ItemStore<T>>;
-    using Itm = std::variant<T, Ptr>;
+        for (auto it = m_order->lower_bound(low);
+             (it != m_order->end()) and std::equal(coord.cbegin(), coord.cbegin() + depth, it->cbegin()); ++it)
+        {
+            acc += 1;
+        }
 
-    using ParentOpt = std::optional<Parent>;
+        return acc;
+    }
 
-    explicit ItemStore(ParentOpt parent = {}) noexcept
-        : m_parent{std::move(parent)}
+    bool has(const Coord& coord) const noexcept
     {
-        assert(empty());
+        return m_store.find(coord) != m_store.end();
     }
 
-    virtual ~ItemStore() = default;
-
-    const ParentOpt& parent() const noexcept
+    T get(const Coord& coord) const noexcept
     {
-        return m_parent;
+        const auto it = m_store.find(coord);
+        return (it != m_store.end()) ? it->second : Default;
     }
 
-    void insert(const typename ITensor<T>::Idx idx, typename ItemStore<T>::Itm itm) noexcept
+    void set(const Coord& coord, const T val)
     {
-        if (has(idx))
+        if (val == Default)
         {
-            m_store.at(idx) = std::move(itm);
+            const auto removed = m_store.erase(coord);
+            PROBE_COUNT("tensor.store.remove", removed);
+
+            if (m_order and removed)
+            {
+                m_order->erase(coord);
+            }
         }
-        else
+        else if (m_store.insert_or_assign(coord, val).second)
         {
-            m_store.emplace(idx, std::move(itm));
+            PROBE_COUNT("tensor.store.insert", 1);
+
+            if (m_order)
+            {
+                m_order->insert(coord);
+            }
         }
     }
 
-    void remove(const typename ITensor<T>::Idx idx) noexcept
+    T add(const Coord& coord, const T delta)
     {
-        assert(has(idx)); m_store.erase(idx);
+        const auto [it, inserted] = m_store.try_emplace(coord, Default);
+        const auto val = static_cast<T>(it->second + delta);
 
-        if (empty() and parent().has_value())
+        if (val == Default)
         {
-            auto [parent_ptr, parent_idx] = parent().value();
-            parent_ptr->remove(parent_idx);
+            if (not inserted)
+            {
+                PROBE_COUNT("tensor.store.remove", 1);
+
+                if (m_order)
+                {
+                    m_order->erase(coord);
+                }
+            }
+            m_store.erase(it);
         }
-    }
+        else
+        {
+            if (inserted)
+            {
+                PROBE_COUNT("tensor.store.insert", 1);
 
-    bool has(const typename ITensor<T>::Idx idx) const noexcept
-    {
-        return m_store.find(idx) != m_store.end();
-    }
+                if (m_order)
+                {
+                    m_order->insert(coord);
+                }
+            }
+            it->second = val;
+        }
 
-    Itm item(const typename ITensor<T>::Idx idx) const noexcept
-    {
-        assert(has(idx)); return m_store.at(idx);
+        return val;
     }
 
-    bool empty() const noexcept
+    template<typename Fn>
+    void for_each(Fn&& fn) const
     {
-        return m_store.empty();
+        for (const auto& [coord, val]: m_store)
+        {
+            fn(coord, val);
+        }
     }
 
 private:
 
-    using HashMap = std::unordered_map<
-         typename ITensor<T>::Idx, typename ItemStore<T>::Itm>;
+    using HashMap = std::pmr::unordered_map<Coord, T, CoordHash<Rank>>;
+    using Order   = std::pmr::set<Coord>;
 
-    ParentOpt const m_parent = {};
     HashMap m_store = {};
 
+    mutable std::unique_ptr<Order> m_order = {};
+
 };
 
 }
@@ -2,8 +2,13 @@
 
 #include <cstddef>
 #include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
 
+#include <expr.hpp>
 #include <iface.hpp>
+#include <store.hpp>
 #include <vector.hpp>
 #include <scalar.hpp>
 
@@ -15,41 +20,246 @@ class Tensor final: public ITensor<T>
 
 public:
 
+    using Store = ItemStore<T, Default, Rank>;
+    using Coord = typename Store::Coord;
+
+    static constexpr T default_value = Default;
+    static constexpr std::size_t rank = Rank;
+
+    class Cell
+    {
+
+    public:
+
+        Cell(Store& store, const Coord& coord) noexcept
+            : m_store{store}
+            , m_coord{coord}
+        {}
+
+        Cell& operator=(const T val)
+        {
+            m_store.set(m_coord, val);
+            return (*this);
+        }
+
+        operator T() const noexcept
+        {
+            return m_store.get(m_coord);
+        }
+
+    private:
+
+        Store& m_store;
+        const Coord m_coord;
+
+    };
+
+    Tensor()
+        : Tensor{std::pmr::get_default_resource()}
+    {}
+
+    explicit Tensor(std::pmr::memory_resource* const upstream)
+        : m_upstream{upstream}
+        , m_arena{std::make_unique<Arena>(upstream)}
+    {}
+
+    Tensor(const Tensor& rhs)
+        : m_upstream{rhs.m_upstream}
+        , m_arena{std::make_unique<Arena>(rhs.m_upstream, rhs.store())}
+    {}
+
+    // Moved-from tensor is empty and usable, its arena is recreated on the next write.
+    Tensor(Tensor&& rhs) noexcept
+        : m_upstream{rhs.m_upstream}
+        , m_arena{std::move(rhs.m_arena)}
+    {}
+
+    Tensor& operator=(const Tensor& rhs)
+    {
+        if (&rhs != this)
+        {
+            auto temp = Tensor{rhs};
+            m_upstream = rhs.m_upstream;
+            std::swap(m_arena, temp.m_arena);
+        }
+        return (*this);
+    }
+
+    Tensor& operator=(Tensor&& rhs) noexcept
+    {
+        if (&rhs != this)
+        {
+            m_upstream = rhs.m_upstream;
+            m_arena = std::move(rhs.m_arena);
+        }
+        return (*this);
+    }
+
+    template<typename E, typename std::enable_if_t<is_expr_v<E>, bool> = true>
+    Tensor(const E& expr)
+        : Tensor{}
+    {
+        assign(expr);
+    }
+
+    template<typename E, typename std::enable_if_t<is_expr_v<E>, bool> = true>
+    Tensor& operator=(const E& expr)
+    {
+        assign(expr);
+        return (*this);
+    }
+
+    ~Tensor() = default;
+
     std::size_t size() const override
     {
-        return m_root->size();
+        if constexpr (Rank > 0)
+        {
+            return store().size();
+        }
+        else
+        {
+            return 1;
+        }
+    }
+
+    template<typename... Idx>
+    T at(const Idx... idx) const noexcept
+    {
+        static_assert(sizeof...(Idx) == Rank, "number of indices should match tensor rank");
+        return store().get(Coord{static_cast<typename ITensor<T>::Idx>(idx)...});
+    }
+
+    // Allocates the arena of a moved-from tensor, so it may throw.
+    template<typename... Idx>
+    Cell operator()(const Idx... idx)
+    {
+        static_assert(sizeof...(Idx) == Rank, "number of indices should match tensor rank");
+        return Cell{arena().store, Coord{static_cast<typename ITensor<T>::Idx>(idx)...}};
+    }
+
+    T get(const Coord& coord) const noexcept
+    {
+        return store().get(coord);
+    }
+
+    void set(const Coord& coord, const T val)
+    {
+        arena().store.set(coord, val);
     }
 
     ITensor<T>& operator[](const typename ITensor<T>::Idx idx) override
     {
-        return m_root->operator[](idx);
+        if constexpr (Rank > 0)
+        {
+            return facade()[idx];
+        }
+        else
+        {
+            throw Exception::NoIndexSubscription{};
+        }
     }
 
     void operator=(const T val) override
     {
-        return m_root->operator=(val);
+        if constexpr (Rank > 0)
+        {
+            throw Exception::NoValueAssignment{};
+        }
+        else
+        {
+            arena().store.set(Coord{}, val);
+        }
     }
 
     operator T() override
     {
-        return m_root->operator T();
+        if constexpr (Rank > 0)
+        {
+            throw Exception::NoValueConversion{};
+        }
+        else
+        {
+            return store().get(Coord{});
+        }
+    }
+
+    template<typename Fn>
+    void for_each(Fn&& fn) const
+    {
+        store().for_each(std::forward<Fn>(fn));
     }
 
 private:
 
-    constexpr auto initialize() -> typename ITensor<T>::Ptr
+    // Evaluates into a fresh arena first, so the expression may refer to this tensor.
+    template<typename E>
+    void assign(const E& expr)
     {
-        if constexpr (Rank > 0)
+        static_assert(E::rank == Rank, "expression rank should match tensor rank");
+        static_assert(std::is_same_v<typename E::value_type, T>, "expression value type should match tensor");
+
+        if (expr.dflt() != Default)
         {
-            return std::make_unique<Vector<T, Default>>(Rank);
+            throw Exception::DefaultMismatch{};
         }
-        else
+
+        auto out = Tensor{m_upstream};
+
+        expr.for_each_occupied([&expr, &out](const Coord& coord)
         {
-            return std::make_unique<Scalar<T, Default>>();
+            out.set(coord, expr.get(coord));
+        });
+
+        std::swap(m_arena, out.m_arena);
+    }
+
+    struct Arena
+    {
+        explicit Arena(std::pmr::memory_resource* const upstream)
+            : pool{upstream}
+        {}
+
+        Arena(std::pmr::memory_resource* const upstream, const Store& rhs)
+            : pool{upstream}
+            , store{rhs, &pool}
+        {}
+
+        std::pmr::unsynchronized_pool_resource pool;
+        Store store{&pool};
+        NodePtr<T> facade = {};
+    };
+
+    Arena& arena()
+    {
+        if (not m_arena)
+        {
+            m_arena = std::make_unique<Arena>(m_upstream);
+        }
+
+        return (*m_arena);
+    }
+
+    const Store& store() const noexcept
+    {
+        static const Store empty = Store{};
+        return m_arena ? m_arena->store : empty;
+    }
+
+    ITensor<T>& facade()
+    {
+        auto& own = arena();
+
+        if (not own.facade)
+        {
+            own.facade = make_node<T, Vector<T, Default, Rank>>(&own.pool, own.store, Coord{}, 0);
         }
+
+        return (*own.facade);
     }
 
-    const typename ITensor<T>::Ptr m_root = initialize();
+    std::pmr::memory_resource* m_upstream = {};
+    std::unique_ptr<Arena> m_arena;
 
 };
 
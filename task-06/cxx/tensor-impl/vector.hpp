@@ -2,7 +2,8 @@
 
 #include <cassert>
 #include <cstddef>
-#include <memory>
+#include <memory_resource>
+#include <unordered_map>
 
 #include <iface.hpp>
 #include <scalar.hpp>
@@ -10,32 +11,39 @@
 
 namespace tensor {
 
-template<typename T, T Default = T{}>
-class Vector
-    : public ItemStore<T>
-    , public std::enable_shared_from_this<Vector<T, Default>>
+// Children are created on first subscript and kept until this node goes away, so a reference
+// returned by operator[] stays valid for the lifetime of the tensor (or until it is reassigned).
+template<typename T, T Default, std::size_t Rank>
+class Vector final: public ITensor<T>
 {
 
 public:
 
-    explicit Vector(const std::size_t height, typename ItemStore<T>::ParentOpt parent = {}) noexcept
-        : ItemStore<T>{std::move(parent)}
-        , m_height{height}
+    using Store = ItemStore<T, Default, Rank>;
+
+    Vector(Store& store, const typename Store::Coord& coord, const std::size_t depth) noexcept
+        : m_store{store}
+        , m_coord{coord}
+        , m_depth{depth}
     {
-        assert(m_height > 0);
+        assert(m_depth < Rank);
+    }
+
+    std::size_t size() const override
+    {
+        return m_store.count_prefix(m_coord, m_depth);
     }
 
     ITensor<T>& operator[](const typename ITensor<T>::Idx idx) override
     {
-        if (not this->has(idx))
+        auto& child = m_children[idx];
+
+        if (not child)
         {
-            this->insert(idx, create_child(idx));
+            child = create_child(idx);
         }
 
-        const auto child_itm = this->item(idx);
-        const auto child_ptr = std::get<typename ItemStore<T>::Ptr>(child_itm);
-
-        return (*child_ptr);
+        return (*child);
     }
 
     void operator=(const T) override
@@ -50,24 +58,28 @@ public:
 
 private:
 
-    auto create_child(const typename ITensor<T>::Idx idx) -> typename ItemStore<T>::Ptr
+    using Child = NodePtr<T>;
+
+    auto create_child(const typename ITensor<T>::Idx idx) -> Child
     {
-        const auto parent = typename ItemStore<T>::Parent(
-        {
-            this->shared_from_this(), idx
-        });
+        auto coord = m_coord;
+        coord[m_depth] = idx;
 
-        if (m_height > 1)
+        if ((m_depth + 1) < Rank)
         {
-            return std::make_unique<Vector<T, Default>>((m_height - 1), parent);
+            return make_node<T, Vector<T, Default, Rank>>(m_store.resource(), m_store, coord, (m_depth + 1));
         }
         else
         {
-            return std::make_unique<Scalar<T, Default>>(parent);
+            return make_node<T, Scalar<T, Default, Rank>>(m_store.resource(), m_store, coord);
         }
     }
 
-    const std::size_t m_height = {};
+    Store& m_store;
+    const typename Store::Coord m_coord;
+    const std::size_t m_depth = {};
+
+    std::pmr::unordered_map<typename ITensor<T>::Idx, Child> m_children{m_store.resource()};
 
 };
 
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#include <iface.hpp>
+
+namespace tensor {
+
+struct Range
+{
+    std::size_t begin = 0;
+    std::size_t end   = std::numeric_limits<std::size_t>::max();
+    std::size_t step  = 1;
+};
+
+// Non-owning window over any sparse source: every source dimension is either
+// pinned to one index or walked through a strided range. Writes go straight
+// to the source, so a view over a const source is read-only. Coordinates
+// outside the window throw std::out_of_range.
+template<typename S, std::size_t ViewRank>
+class View final
+{
+
+public:
+
+    using Idx      = typename ITensor<std::remove_cv_t<decltype(S::default_value)>>::Idx;
+    using Coord    = std::array<Idx, ViewRank>;
+    using SrcCoord = std::array<Idx, S::rank>;
+    using T        = std::remove_cv_t<decltype(S::default_value)>;
+
+    static constexpr T default_value = S::default_value;
+    static constexpr std::size_t rank = ViewRank;
+
+    struct Axis
+    {
+        bool  fixed = false;
+        Range range = {};
+    };
+
+    using Axes = std::array<Axis, S::rank>;
+
+    View(S& src, const Axes& axes)
+        : m_src{src}
+        , m_axes{axes}
+    {
+        std::size_t free = 0;
+
+        for (std::size_t dim{0}; dim < S::rank; ++dim)
+        {
+            if (m_axes[dim].range.step == 0)
+            {
+                throw Exception::DimensionMismatch{};
+            }
+
+            if (not m_axes[dim].fixed)
+            {
+                if (free == ViewRank)
+                {
+                    throw Exception::DimensionMismatch{};
+                }
+
+                free += 1;
+            }
+        }
+
+        if (free != ViewRank)
+        {
+            throw Exception::DimensionMismatch{};
+        }
+
+        for (std::size_t dim{0}, idx{0}; dim < S::rank; ++dim)
+        {
+            if (not m_axes[dim].fixed)
+            {
+                const auto& range = m_axes[dim].range;
+                m_extent[idx++] = (range.end > range.begin) ? ((range.end - range.begin - 1) / range.step + 1) : 0;
+            }
+        }
+    }
+
+    // Number of window cells, saturated at max() for unbounded ranges.
+    std::size_t volume() const noexcept
+    {
+        std::size_t acc = 1;
+
+        for (const auto extent: m_extent)
+        {
+            if (extent == 0)
+            {
+                return 0;
+            }
+            acc = (acc > std::numeric_limits<std::size_t>::max() / extent)
+                ? std::numeric_limits<std::size_t>::max() : (acc * extent);
+        }
+
+        return acc;
+    }
+
+    // O(min(volume(), source nnz)), see for_each().
+    std::size_t size() const
+    {
+        decltype(size()) acc = {};
+
+        for_each([&acc](const Coord&, const T)
+        {
+            acc += 1;
+        });
+
+        return acc;
+    }
+
+    template<typename... I>
+    T at(const I... idx) const
+    {
+        static_assert(sizeof...(I) == ViewRank, "number of indices should match view rank");
+        return get(Coord{static_cast<Idx>(idx)...});
+    }
+
+    T get(const Coord& coord) const
+    {
+        return m_src.get(to_source(coord));
+    }
+
+    void set(const Coord& coord, const T val)
+    {
+        m_src.set(to_source(coord), val);
+    }
+
+    // Reports occupied cells inside the view in O(min(volume(), source nnz)): small windows
+    // probe their own cells, larger ones filter a single pass over the source.
+    template<typename Fn>
+    void for_each(Fn&& fn) const
+    {
+        const auto cells = volume();
+
+        if (cells == 0)
+        {
+            return;
+        }
+
+        if (cells <= m_src.size())
+        {
+            auto coord = Coord{};
+
+            for (std::size_t it{0}; it < cells; ++it)
+            {
+                const T val = m_src.get(to_source(coord));
+
+                if (val != default_value)
+                {
+                    fn(static_cast<const Coord&>(coord), val);
+                }
+
+                for (std::size_t dim{ViewRank}; dim > 0; --dim)
+                {
+                    if (++coord[dim - 1] < m_extent[dim - 1])
+                    {
+                        break;
+                    }
+                    coord[dim - 1] = 0;
+                }
+            }
+            return;
+        }
+
+        m_src.for_each([this, &fn](const SrcCoord& src, const T val)
+        {
+            auto coord = Coord{};
+
+            if (to_view(src, coord))
+            {
+                fn(static_cast<const Coord&>(coord), val);
+            }
+        });
+    }
+
+private:
+
+    SrcCoord to_source(const Coord& coord) const
+    {
+        auto src = SrcCoord{};
+        auto dim = std::size_t{0};
+
+        for (std::size_t it{0}; it < S::rank; ++it)
+        {
+            const auto& [fixed, range] = m_axes[it];
+
+            if (fixed)
+            {
+                src[it] = range.begin;
+                continue;
+            }
+
+            if (coord[dim] >= m_extent[dim])
+            {
+                throw std::out_of_range{"view coordinate is outside of its window"};
+            }
+
+            src[it] = range.begin + coord[dim++] * range.step;
+        }
+
+        return src;
+    }
+
+    bool to_view(const SrcCoord& src, Coord& coord) const noexcept
+    {
+        auto dim = std::size_t{0};
+
+        for (std::size_t it{0}; it < S::rank; ++it)
+        {
+            const auto& [fixed, range] = m_axes[it];
+
+            if (fixed)
+            {
+                if (src[it] != range.begin)
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            if ((src[it] < range.begin) or (src[it] >= range.end) or ((src[it] - range.begin) % range.step))
+            {
+                return false;
+            }
+
+            coord[dim++] = (src[it] - range.begin) / range.step;
+        }
+
+        return true;
+    }
+
+    S& m_src;
+    const Axes m_axes;
+    Coord m_extent = {};
+
+};
+
+template<typename S>
+auto slice(S& src, const std::array<Range, S::rank>& ranges) -> View<S, S::rank>
+{
+    auto axes = typename View<S, S::rank>::Axes{};
+
+    for (std::size_t dim{0}; dim < S::rank; ++dim)
+    {
+        axes[dim].range = ranges[dim];
+    }
+
+    return View<S, S::rank>{src, axes};
+}
+
+template<std::size_t Dim, typename S>
+auto project(S& src, const std::size_t idx) -> View<S, (S::rank - 1)>
+{
+    static_assert(Dim < S::rank, "projected dimension should exist in source");
+
+    auto axes = typename View<S, (S::rank - 1)>::Axes{};
+    axes[Dim] = {true, Range{idx, (idx + 1), 1}};
+
+    return View<S, (S::rank - 1)>{src, axes};
+}
+
+template<typename S>
+auto row(S& src, const std::size_t idx)
+{
+    static_assert(S::rank == 2, "row view requires a matrix");
+    return project<0>(src, idx);
+}
+
+template<typename S>
+auto column(S& src, const std::size_t idx)
+{
+    static_assert(S::rank == 2, "column view requires a matrix");
+    return project<1>(src, idx);
+}
+
+}